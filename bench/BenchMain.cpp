@@ -0,0 +1,218 @@
+// cinderpeak_bench: single-threaded micro-benchmarks of the storage engines.
+//
+// Every run generates its graphs in-process, so nothing is downloaded or
+// read from disk, and prints one JSON document that can be diffed between
+// releases:
+//
+//   cinderpeak_bench [--scale N] [--edge-factor N] [--queries N]
+//                    [--seed N] [--filter TEXT] [--out FILE]
+#include "Generators.hpp"
+#include "PeakStore.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace CinderPeak;
+using namespace CinderPeak::PeakStore;
+using CinderPeak::Bench::EdgeList;
+
+namespace {
+
+struct Options {
+  size_t scale = 12;
+  size_t edge_factor = 8;
+  size_t queries = 100000;
+  std::uint64_t seed = 42;
+  // Only runs whose "engine/vertex_type/graph" contains this are kept.
+  std::string filter;
+  std::string out;
+};
+
+struct Result {
+  std::string engine;
+  std::string vertex_type;
+  std::string graph;
+  std::string operation;
+  size_t ops = 0;
+  double seconds = 0;
+  LatencyHistogram::Summary latency;
+};
+
+// Keeps results alive so the compiler cannot drop the measured calls.
+volatile size_t sink = 0;
+
+// Times fn(i) for i in [0, count). Throughput comes from the wall time of
+// the whole loop; the per-call latencies include one steady_clock read.
+template <typename Fn>
+Result measure(const std::string &operation, size_t count, Fn &&fn) {
+  auto histogram = std::make_unique<LatencyHistogram>();
+  const auto start = std::chrono::steady_clock::now();
+  auto last = start;
+  for (size_t i = 0; i < count; ++i) {
+    fn(i);
+    const auto now = std::chrono::steady_clock::now();
+    histogram->record(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - last)
+            .count()));
+    last = now;
+  }
+  Result result;
+  result.operation = operation;
+  result.ops = count;
+  result.seconds = std::chrono::duration<double>(last - start).count();
+  result.latency = histogram->summary();
+  return result;
+}
+
+template <typename VertexType, template <typename, typename> class Engine>
+void runEngine(const char *engine, const EdgeList &graph,
+               const Options &options, std::vector<Result> &results) {
+  using Factory = Bench::VertexFactory<VertexType>;
+  const std::string label =
+      std::string(engine) + "/" + Factory::name() + "/" + graph.name;
+  if (label.find(options.filter) == std::string::npos)
+    return;
+  std::cerr << "running " << label << "\n";
+
+  const std::vector<VertexType> vertices = Factory::make(graph.num_vertices);
+  GraphInternalMetadata metadata("graph_list", isTypePrimitive<VertexType>(),
+                                 isTypePrimitive<int>());
+  GraphCreationOptions create_options(
+      {GraphCreationOptions::Directed, GraphCreationOptions::Weighted});
+  CinderPeak::PeakStore::PeakStore<VertexType, int, StaticStorage<Engine>>
+      store(metadata, create_options);
+  Bench::Rng rng(options.seed ^ 0x5EED);
+
+  std::vector<Result> runs;
+  runs.push_back(measure("add_vertex", vertices.size(), [&](size_t i) {
+    sink = sink + store.addVertex(vertices[i]).isOK();
+  }));
+  runs.push_back(measure("add_edge", graph.edges.size(), [&](size_t i) {
+    const auto &[src, dest] = graph.edges[i];
+    sink = sink +
+           store.addEdge(vertices[src], vertices[dest], static_cast<int>(i))
+               .isOK();
+  }));
+  runs.push_back(measure("get_edge", options.queries, [&](size_t) {
+    const auto &[src, dest] = graph.edges[rng.below(graph.edges.size())];
+    sink = sink + store.getEdge(vertices[src], vertices[dest]).first;
+  }));
+  runs.push_back(measure("get_neighbors", options.queries, [&](size_t) {
+    const auto &v = vertices[rng.below(vertices.size())];
+    sink = sink + store.getNeighbors(v).first.size();
+  }));
+  for (auto &run : runs) {
+    run.engine = engine;
+    run.vertex_type = Factory::name();
+    run.graph = graph.name;
+    results.push_back(std::move(run));
+  }
+}
+
+template <typename VertexType>
+void runVertexType(const std::vector<EdgeList> &graphs,
+                   const Options &options, std::vector<Result> &results) {
+  for (const auto &graph : graphs) {
+    runEngine<VertexType, AdjacencyList>("adjacency_list", graph, options,
+                                         results);
+    runEngine<VertexType, HybridCSR_COO>("hybrid_csr", graph, options,
+                                         results);
+  }
+}
+
+std::string toJson(const Options &options,
+                   const std::vector<EdgeList> &graphs,
+                   const std::vector<Result> &results) {
+  std::ostringstream out;
+  out << "{\n  \"suite\": \"cinderpeak_bench\",\n  \"config\": {"
+      << "\"scale\": " << options.scale
+      << ", \"edge_factor\": " << options.edge_factor
+      << ", \"queries\": " << options.queries << ", \"seed\": " << options.seed
+      << "},\n  \"graphs\": [";
+  for (size_t i = 0; i < graphs.size(); ++i) {
+    out << (i ? ", " : "") << "{\"name\": \"" << graphs[i].name
+        << "\", \"vertices\": " << graphs[i].num_vertices
+        << ", \"edges\": " << graphs[i].edges.size() << "}";
+  }
+  out << "],\n  \"results\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result &r = results[i];
+    const double ops_per_sec = r.seconds > 0 ? r.ops / r.seconds : 0;
+    out << (i ? "," : "") << "\n    {\"engine\": \"" << r.engine
+        << "\", \"vertex_type\": \"" << r.vertex_type << "\", \"graph\": \""
+        << r.graph << "\", \"operation\": \"" << r.operation
+        << "\", \"ops\": " << r.ops << ", \"seconds\": " << r.seconds
+        << ", \"ops_per_sec\": " << static_cast<std::uint64_t>(ops_per_sec)
+        << ", \"latency_ns\": {\"p50\": " << r.latency.p50_ns
+        << ", \"p90\": " << r.latency.p90_ns
+        << ", \"p99\": " << r.latency.p99_ns
+        << ", \"p999\": " << r.latency.p999_ns
+        << ", \"max\": " << r.latency.max_ns << "}}";
+  }
+  out << "\n  ]\n}\n";
+  return out.str();
+}
+
+bool parseArgs(int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h" || i + 1 >= argc)
+      return false;
+    const char *value = argv[++i];
+    if (arg == "--scale")
+      options.scale = std::strtoull(value, nullptr, 10);
+    else if (arg == "--edge-factor")
+      options.edge_factor = std::strtoull(value, nullptr, 10);
+    else if (arg == "--queries")
+      options.queries = std::strtoull(value, nullptr, 10);
+    else if (arg == "--seed")
+      options.seed = std::strtoull(value, nullptr, 10);
+    else if (arg == "--filter")
+      options.filter = value;
+    else if (arg == "--out")
+      options.out = value;
+    else
+      return false;
+  }
+  return options.scale > 0 && options.scale < 31 && options.edge_factor > 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseArgs(argc, argv, options)) {
+    std::cerr << "usage: cinderpeak_bench [--scale N] [--edge-factor N] "
+                 "[--queries N] [--seed N] [--filter TEXT] [--out FILE]\n";
+    return 2;
+  }
+
+  const size_t vertices = size_t{1} << options.scale;
+  const std::vector<EdgeList> graphs = {
+      Bench::uniformGraph(vertices, vertices * options.edge_factor,
+                          options.seed),
+      Bench::rmatGraph(options.scale, options.edge_factor, options.seed)};
+
+  std::vector<Result> results;
+  runVertexType<int>(graphs, options, results);
+  runVertexType<std::string>(graphs, options, results);
+  runVertexType<CinderVertex>(graphs, options, results);
+
+  const std::string json = toJson(options, graphs, results);
+  if (options.out.empty()) {
+    std::cout << json;
+  } else {
+    std::ofstream file(options.out);
+    file << json;
+    if (!file) {
+      std::cerr << "cannot write " << options.out << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include "StorageEngine/Utils.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+namespace CinderPeak {
+namespace Bench {
+
+// SplitMix64. Unlike the <random> distributions its output is the same on
+// every platform, so a seed names the same graph everywhere.
+class Rng {
+public:
+  explicit Rng(std::uint64_t seed) : state(seed) {}
+  std::uint64_t next() {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+  // Uniform in [0, bound); the modulo bias is negligible for graph sizes.
+  size_t below(size_t bound) { return static_cast<size_t>(next() % bound); }
+  double unit() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+private:
+  std::uint64_t state;
+};
+
+// A generated graph over vertex indices [0, num_vertices). Edges contain
+// neither self loops nor duplicates.
+struct EdgeList {
+  std::string name;
+  size_t num_vertices = 0;
+  std::vector<std::pair<size_t, size_t>> edges;
+};
+
+namespace detail {
+inline void dedupe(EdgeList &graph) {
+  std::unordered_set<std::uint64_t> seen;
+  seen.reserve(graph.edges.size());
+  std::vector<std::pair<size_t, size_t>> kept;
+  kept.reserve(graph.edges.size());
+  for (const auto &[src, dest] : graph.edges) {
+    if (src != dest &&
+        seen.insert(std::uint64_t{src} * graph.num_vertices + dest).second)
+      kept.emplace_back(src, dest);
+  }
+  graph.edges = std::move(kept);
+}
+} // namespace detail
+
+// Erdos-Renyi style G(n, m): `edges` endpoints drawn uniformly, so degrees
+// are nearly equal.
+inline EdgeList uniformGraph(size_t vertices, size_t edges,
+                             std::uint64_t seed) {
+  EdgeList graph{"uniform", vertices, {}};
+  Rng rng(seed);
+  graph.edges.reserve(edges);
+  for (size_t i = 0; i < edges; ++i)
+    graph.edges.emplace_back(rng.below(vertices), rng.below(vertices));
+  detail::dedupe(graph);
+  return graph;
+}
+
+// R-MAT (Chakrabarti et al.) with the Graph500 parameters a = 0.57,
+// b = c = 0.19: a skewed, power-law degree distribution with a few hub
+// vertices, 2^scale vertices and about edge_factor * 2^scale edges.
+inline EdgeList rmatGraph(size_t scale, size_t edge_factor,
+                          std::uint64_t seed) {
+  const size_t vertices = size_t{1} << scale;
+  EdgeList graph{"rmat", vertices, {}};
+  Rng rng(seed);
+  graph.edges.reserve(vertices * edge_factor);
+  for (size_t i = 0; i < vertices * edge_factor; ++i) {
+    size_t src = 0, dest = 0;
+    for (size_t bit = 0; bit < scale; ++bit) {
+      const double r = rng.unit();
+      const bool down = r >= 0.57 + 0.19; // quadrants c and d
+      const bool right = (r >= 0.57 && r < 0.76) || r >= 0.95;
+      src = (src << 1) | down;
+      dest = (dest << 1) | right;
+    }
+    graph.edges.emplace_back(src, dest);
+  }
+  detail::dedupe(graph);
+  return graph;
+}
+
+// Maps vertex indices to the benchmarked vertex type.
+template <typename VertexType> struct VertexFactory;
+
+template <> struct VertexFactory<int> {
+  static const char *name() { return "int"; }
+  static std::vector<int> make(size_t count) {
+    std::vector<int> out(count);
+    for (size_t i = 0; i < count; ++i)
+      out[i] = static_cast<int>(i);
+    return out;
+  }
+};
+template <> struct VertexFactory<std::string> {
+  static const char *name() { return "string"; }
+  static std::vector<std::string> make(size_t count) {
+    std::vector<std::string> out;
+    out.reserve(count);
+    // Long enough to defeat the small-string optimization.
+    for (size_t i = 0; i < count; ++i)
+      out.push_back("benchmark_vertex_" + std::to_string(i));
+    return out;
+  }
+};
+template <> struct VertexFactory<CinderVertex> {
+  static const char *name() { return "CinderVertex"; }
+  static std::vector<CinderVertex> make(size_t count) {
+    return std::vector<CinderVertex>(count);
+  }
+};
+
+} // namespace Bench
+} // namespace CinderPeak
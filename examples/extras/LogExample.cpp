@@ -5,6 +5,8 @@ int main() {
     Logger::enableConsoleLogging = true;
     Logger::enableFileLogging = true;
     // Logger::logFileName = "custom_logs.txt";
+    // Format and write on a background thread; callers only enqueue.
+    Logger::enableAsync(8192, LogOverflow::Block);
 
     LOG_INFO("System initialized");
     LOG_WARNING("This might be risky...");
@@ -12,6 +14,8 @@ int main() {
     LOG_DEBUG("This is a debug message");
     LOG_TRACE("This is a trace");
     LOG_CRITICAL("Hardward read write faliure");
+    // Arguments are only formatted when the record is written.
+    LOG_INFO("Loaded {} vertices in {} ms", 42, 3.5);
 
     // Logger::shutdown(); // optional cleanup
 }
@@ -0,0 +1,255 @@
+#pragma once
+#include "Concurrency/ThreadPool.hpp"
+#include "StorageEngine/CsrSnapshot.hpp"
+#include "StorageEngine/MatrixBlock.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+namespace CinderPeak {
+namespace Algorithms {
+
+using PeakStore::CsrSnapshot;
+using PeakStore::INVALID_VERTEX_ID;
+using PeakStore::VertexId;
+
+// Switching thresholds of the direction-optimizing BFS (Beamer et al.,
+// "Direction-Optimizing Breadth-First Search"). A search goes bottom-up
+// once the frontier's out-edges exceed 1/alpha of the edges left to check,
+// and back to top-down once the frontier shrinks below 1/beta of the
+// vertices.
+struct BfsOptions {
+  double alpha = 15.0;
+  double beta = 18.0;
+};
+
+// Dense results indexed by VertexId. Unreached vertices have distance
+// UNREACHED and parent INVALID_VERTEX_ID; the source is its own parent.
+struct BfsResult {
+  static constexpr VertexId UNREACHED = INVALID_VERTEX_ID;
+  std::vector<VertexId> distances;
+  std::vector<VertexId> parents;
+  size_t reached = 0;
+};
+
+namespace detail {
+
+// Frontier bitmap with one atomic word per 64 vertices, so steps that own
+// whole words can store them outright and others can fetch_or single bits.
+class FrontierBitmap {
+public:
+  explicit FrontierBitmap(size_t bits)
+      : count((bits + 63) / 64),
+        words(new std::atomic<std::uint64_t>[count]()) {}
+
+  size_t wordCount() const { return count; }
+  bool test(size_t bit) const {
+    return (words[bit / 64].load(std::memory_order_relaxed) >> (bit % 64)) & 1;
+  }
+  void set(size_t bit) {
+    words[bit / 64].fetch_or(std::uint64_t{1} << (bit % 64),
+                             std::memory_order_relaxed);
+  }
+  std::uint64_t word(size_t w) const {
+    return words[w].load(std::memory_order_relaxed);
+  }
+  void storeWord(size_t w, std::uint64_t value) {
+    words[w].store(value, std::memory_order_relaxed);
+  }
+  void swap(FrontierBitmap &other) {
+    std::swap(count, other.count);
+    std::swap(words, other.words);
+  }
+
+private:
+  size_t count;
+  std::unique_ptr<std::atomic<std::uint64_t>[]> words;
+};
+
+// Appends a task's discoveries to the shared queue with one fetch_add.
+inline void appendToQueue(std::vector<VertexId> &queue,
+                          std::atomic<size_t> &tail,
+                          const std::vector<VertexId> &local) {
+  if (local.empty())
+    return;
+  const size_t at = tail.fetch_add(local.size(), std::memory_order_relaxed);
+  std::copy(local.begin(), local.end(), queue.begin() + at);
+}
+
+} // namespace detail
+
+// Direction-optimizing BFS over the out-edges of `graph`. Top-down steps
+// expand a queue frontier and claim vertices with a CAS on their parent;
+// bottom-up steps let every unvisited vertex scan its in-edges for a parent
+// in a bitmap frontier, which touches far fewer edges once the frontier
+// holds a large part of the graph. Bottom-up steps read `transpose`, built
+// on first use when not given. Both kinds of step run on `pool`, which
+// splits them by degree. Parents, but not distances, may differ between
+// runs when a vertex has several parents at the same depth.
+template <typename EdgeType>
+BfsResult bfs(const CsrSnapshot<EdgeType> &graph, VertexId source,
+              Concurrency::ThreadPool &pool, const BfsOptions &options = {},
+              const CsrSnapshot<EdgeType> *transpose = nullptr) {
+  const size_t n = graph.numVertices();
+  BfsResult result;
+  result.distances.assign(n, BfsResult::UNREACHED);
+  result.parents.assign(n, INVALID_VERTEX_ID);
+  if (source >= n)
+    return result;
+
+  const size_t *offsets = graph.offsets();
+  const VertexId *cols = graph.cols();
+  std::optional<CsrSnapshot<EdgeType>> built_transpose;
+  std::unique_ptr<std::atomic<VertexId>[]> parent(
+      new std::atomic<VertexId>[n]);
+  pool.parallel_for(0, n, [&](size_t lo, size_t hi) {
+    for (size_t v = lo; v < hi; ++v)
+      parent[v].store(INVALID_VERTEX_ID, std::memory_order_relaxed);
+  });
+  std::vector<VertexId> &distance = result.distances;
+  parent[source].store(source, std::memory_order_relaxed);
+  distance[source] = 0;
+
+  // The frontier is queue[head, tail); a top-down step appends the next one
+  // behind it.
+  std::vector<VertexId> queue(n);
+  size_t head = 0, tail = 1;
+  queue[0] = source;
+  std::atomic<size_t> next_tail{tail};
+  detail::FrontierBitmap front(n), next(n);
+
+  auto top_down = [&](VertexId depth) {
+    std::atomic<size_t> scout{0};
+    pool.parallel_for(head, tail, [&](size_t lo, size_t hi) {
+      std::vector<VertexId> local;
+      size_t local_scout = 0;
+      for (size_t i = lo; i < hi; ++i) {
+        const VertexId u = queue[i];
+        for (size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+          const VertexId v = cols[e];
+          VertexId unvisited = INVALID_VERTEX_ID;
+          if (parent[v].load(std::memory_order_relaxed) == INVALID_VERTEX_ID &&
+              parent[v].compare_exchange_strong(unvisited, u,
+                                                std::memory_order_relaxed)) {
+            distance[v] = depth + 1;
+            local.push_back(v);
+            local_scout += offsets[v + 1] - offsets[v];
+          }
+        }
+      }
+      detail::appendToQueue(queue, next_tail, local);
+      scout.fetch_add(local_scout, std::memory_order_relaxed);
+    });
+    head = tail;
+    tail = next_tail.load(std::memory_order_relaxed);
+    return scout.load(std::memory_order_relaxed);
+  };
+
+  // Claims every unvisited vertex with an in-neighbor in `front` and
+  // returns how many there were and the sum of their out-degrees. Tasks
+  // own whole bitmap words.
+  auto bottom_up = [&](const CsrSnapshot<EdgeType> &in, VertexId depth) {
+    const size_t *in_offsets = in.offsets();
+    const VertexId *in_cols = in.cols();
+    std::atomic<size_t> awake{0}, scout{0};
+    pool.parallel_for_weighted(
+        0, front.wordCount(),
+        [&](size_t w) { return in_offsets[std::min(n, w * 64)] + w; },
+        [&](size_t lo, size_t hi) {
+          size_t local_awake = 0, local_scout = 0;
+          for (size_t w = lo; w < hi; ++w) {
+            std::uint64_t bits = 0;
+            for (size_t v = w * 64; v < std::min(n, w * 64 + 64); ++v) {
+              if (parent[v].load(std::memory_order_relaxed) !=
+                  INVALID_VERTEX_ID)
+                continue;
+              for (size_t e = in_offsets[v]; e < in_offsets[v + 1]; ++e) {
+                if (front.test(in_cols[e])) {
+                  parent[v].store(in_cols[e], std::memory_order_relaxed);
+                  distance[v] = depth + 1;
+                  bits |= std::uint64_t{1} << (v % 64);
+                  ++local_awake;
+                  local_scout += offsets[v + 1] - offsets[v];
+                  break;
+                }
+              }
+            }
+            next.storeWord(w, bits);
+          }
+          awake.fetch_add(local_awake, std::memory_order_relaxed);
+          scout.fetch_add(local_scout, std::memory_order_relaxed);
+        });
+    front.swap(next);
+    return std::make_pair(awake.load(std::memory_order_relaxed),
+                          scout.load(std::memory_order_relaxed));
+  };
+
+  size_t edges_to_check = graph.numEdges();
+  size_t scout_count = offsets[source + 1] - offsets[source];
+  VertexId depth = 0;
+  while (head < tail) {
+    if (static_cast<double>(scout_count) >
+        static_cast<double>(edges_to_check) / options.alpha) {
+      if (!transpose) {
+        built_transpose.emplace(graph.transposed(pool));
+        transpose = &*built_transpose;
+      }
+      pool.parallel_for(0, front.wordCount(), [&](size_t lo, size_t hi) {
+        for (size_t w = lo; w < hi; ++w)
+          front.storeWord(w, 0);
+      });
+      pool.parallel_for(head, tail, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i)
+          front.set(queue[i]);
+      });
+      // Every step examines its frontier's edges, the same as top-down.
+      size_t awake = tail - head, previous, frontier_edges = scout_count;
+      do {
+        previous = awake;
+        edges_to_check -= std::min(edges_to_check, frontier_edges);
+        std::tie(awake, frontier_edges) = bottom_up(*transpose, depth++);
+      } while (awake >= previous ||
+               static_cast<double>(awake) >
+                   static_cast<double>(n) / options.beta);
+      // Back to a queue for the remaining top-down steps.
+      next_tail.store(0, std::memory_order_relaxed);
+      std::atomic<size_t> scout{0};
+      pool.parallel_for(0, front.wordCount(), [&](size_t lo, size_t hi) {
+        std::vector<VertexId> local;
+        size_t local_scout = 0;
+        for (size_t w = lo; w < hi; ++w) {
+          for (std::uint64_t bits = front.word(w); bits; bits &= bits - 1) {
+            const size_t v = w * 64 + PeakStore::countTrailingZeros(bits);
+            local.push_back(static_cast<VertexId>(v));
+            local_scout += offsets[v + 1] - offsets[v];
+          }
+        }
+        detail::appendToQueue(queue, next_tail, local);
+        scout.fetch_add(local_scout, std::memory_order_relaxed);
+      });
+      head = 0;
+      tail = next_tail.load(std::memory_order_relaxed);
+      scout_count = scout.load(std::memory_order_relaxed);
+    } else {
+      edges_to_check -= std::min(edges_to_check, scout_count);
+      scout_count = top_down(depth++);
+    }
+  }
+
+  pool.parallel_for(0, n, [&](size_t lo, size_t hi) {
+    for (size_t v = lo; v < hi; ++v)
+      result.parents[v] = parent[v].load(std::memory_order_relaxed);
+  });
+  result.reached = static_cast<size_t>(
+      std::count_if(distance.begin(), distance.end(), [](VertexId d) {
+        return d != BfsResult::UNREACHED;
+      }));
+  return result;
+}
+
+} // namespace Algorithms
+} // namespace CinderPeak
@@ -0,0 +1,205 @@
+#pragma once
+#include "Concurrency/ThreadPool.hpp"
+#include "StorageEngine/CsrSnapshot.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+namespace CinderPeak {
+namespace Algorithms {
+
+using PeakStore::CsrSnapshot;
+using PeakStore::VertexId;
+
+struct ComponentsOptions {
+  // Leading out-edges of every row linked before the giant component is
+  // guessed; Sutton et al. find two enough on most graphs.
+  size_t neighbor_rounds = 2;
+  // Vertices sampled to find the most common component.
+  size_t samples = 1024;
+  // Set when every edge is stored in both directions, so that out-edges
+  // double as in-edges.
+  bool symmetric = false;
+};
+
+// components[v] is the component of VertexId v, numbered densely from 0 in
+// order of each component's smallest vertex; sizes[c] counts its vertices.
+// Ids the snapshot holds no vertex for are labelled INVALID_VERTEX_ID.
+struct ComponentsResult {
+  std::vector<VertexId> components;
+  std::vector<size_t> sizes;
+};
+
+namespace detail {
+
+// Joins the trees of u and v by hooking the higher root under the lower
+// one. A failed CAS means another task hooked that root first, so the
+// roots are looked up again.
+inline void link(VertexId u, VertexId v, std::atomic<VertexId> *comp) {
+  VertexId p1 = comp[u].load(std::memory_order_relaxed);
+  VertexId p2 = comp[v].load(std::memory_order_relaxed);
+  while (p1 != p2) {
+    const VertexId high = std::max(p1, p2), low = std::min(p1, p2);
+    VertexId p_high = comp[high].load(std::memory_order_relaxed);
+    if (p_high == low)
+      break;
+    if (p_high == high &&
+        comp[high].compare_exchange_strong(p_high, low,
+                                           std::memory_order_relaxed))
+      break;
+    p1 = comp[comp[high].load(std::memory_order_relaxed)].load(
+        std::memory_order_relaxed);
+    p2 = comp[low].load(std::memory_order_relaxed);
+  }
+}
+
+// Points every vertex straight at its root.
+inline void compress(std::atomic<VertexId> *comp, size_t n,
+                     Concurrency::ThreadPool &pool) {
+  pool.parallel_for(0, n, [&](size_t lo, size_t hi) {
+    for (size_t v = lo; v < hi; ++v) {
+      VertexId parent = comp[v].load(std::memory_order_relaxed);
+      VertexId grand = comp[parent].load(std::memory_order_relaxed);
+      while (parent != grand) {
+        comp[v].store(grand, std::memory_order_relaxed);
+        parent = grand;
+        grand = comp[parent].load(std::memory_order_relaxed);
+      }
+    }
+  });
+}
+
+} // namespace detail
+
+// Weakly connected components by Afforest (Sutton et al., "Optimizing
+// Parallel Graph Connectivity Computation via Subgraph Sampling"). A
+// lock-free union-find first links only the leading neighbor_rounds edges of
+// every row, which on most graphs already gathers the giant component. The
+// component that most sampled vertices landed in is taken as the giant one,
+// and the final pass links the remaining edges of all other vertices only.
+//
+// Skipping the giant component needs the in-edges of the other vertices:
+// from `transpose`, or from the rows themselves for symmetric graphs.
+// Without either, every edge has to be read anyway, so sampling is skipped
+// and all edges are linked in a single pass.
+template <typename EdgeType>
+ComponentsResult
+connectedComponents(const CsrSnapshot<EdgeType> &graph,
+                    Concurrency::ThreadPool &pool,
+                    const ComponentsOptions &options = {},
+                    const CsrSnapshot<EdgeType> *transpose = nullptr) {
+  const size_t n = graph.numVertices();
+  const size_t *offsets = graph.offsets();
+  const VertexId *cols = graph.cols();
+  auto by_degree = [offsets](size_t v) { return offsets[v] + v; };
+  const bool skip_giant = transpose || options.symmetric;
+  const size_t rounds = skip_giant ? options.neighbor_rounds : 0;
+  ComponentsResult result;
+  if (n == 0)
+    return result;
+
+  std::unique_ptr<std::atomic<VertexId>[]> comp(new std::atomic<VertexId>[n]);
+  pool.parallel_for(0, n, [&](size_t lo, size_t hi) {
+    for (size_t v = lo; v < hi; ++v)
+      comp[v].store(static_cast<VertexId>(v), std::memory_order_relaxed);
+  });
+
+  for (size_t round = 0; round < rounds; ++round) {
+    pool.parallel_for(0, n, [&](size_t lo, size_t hi) {
+      for (size_t u = lo; u < hi; ++u) {
+        if (offsets[u] + round < offsets[u + 1])
+          detail::link(static_cast<VertexId>(u), cols[offsets[u] + round],
+                       comp.get());
+      }
+    });
+    detail::compress(comp.get(), n, pool);
+  }
+
+  VertexId giant = PeakStore::INVALID_VERTEX_ID;
+  if (skip_giant) {
+    // A fixed seed keeps runs reproducible; the guess only affects speed.
+    std::mt19937 rng(27491095);
+    std::uniform_int_distribution<size_t> pick(0, n - 1);
+    std::unordered_map<VertexId, size_t> seen;
+    for (size_t i = 0; i < options.samples; ++i) {
+      // Ids without a vertex are singletons; drawing one wastes the sample.
+      const size_t v = pick(rng);
+      if (graph.isVertex(static_cast<VertexId>(v)))
+        ++seen[comp[v].load(std::memory_order_relaxed)];
+    }
+    size_t giant_hits = 0;
+    for (const auto &[root, hits] : seen) {
+      if (hits > giant_hits) {
+        giant = root;
+        giant_hits = hits;
+      }
+    }
+  }
+
+  const size_t *in_offsets = transpose ? transpose->offsets() : nullptr;
+  const VertexId *in_cols = transpose ? transpose->cols() : nullptr;
+  pool.parallel_for_weighted(0, n, by_degree, [&](size_t lo, size_t hi) {
+    for (size_t u = lo; u < hi; ++u) {
+      if (comp[u].load(std::memory_order_relaxed) == giant)
+        continue;
+      const VertexId from = static_cast<VertexId>(u);
+      for (size_t e = offsets[u] + rounds; e < offsets[u + 1]; ++e)
+        detail::link(from, cols[e], comp.get());
+      if (transpose) {
+        for (size_t e = in_offsets[u]; e < in_offsets[u + 1]; ++e)
+          detail::link(from, in_cols[e], comp.get());
+      }
+    }
+  });
+  detail::compress(comp.get(), n, pool);
+
+  // Every root is the smallest vertex of its tree, so numbering roots in
+  // order numbers components by their smallest vertex. Ids without a vertex
+  // have no edges and stay their own roots.
+  result.components.resize(n);
+  std::vector<VertexId> &label = result.components;
+  VertexId count = 0;
+  for (size_t v = 0; v < n; ++v) {
+    if (!graph.isVertex(static_cast<VertexId>(v)))
+      label[v] = PeakStore::INVALID_VERTEX_ID;
+    else if (comp[v].load(std::memory_order_relaxed) == v)
+      label[v] = count++;
+  }
+  std::unique_ptr<std::atomic<size_t>[]> sizes(
+      new std::atomic<size_t>[count]());
+  pool.parallel_for(0, n, [&](size_t lo, size_t hi) {
+    // Neighboring ids often share a component; count runs before adding.
+    VertexId run_root = PeakStore::INVALID_VERTEX_ID;
+    size_t run = 0;
+    for (size_t v = lo; v < hi; ++v) {
+      if (label[v] == PeakStore::INVALID_VERTEX_ID)
+        continue;
+      const VertexId root = comp[v].load(std::memory_order_relaxed);
+      if (root != run_root) {
+        if (run)
+          sizes[label[run_root]].fetch_add(run, std::memory_order_relaxed);
+        run_root = root;
+        run = 0;
+      }
+      ++run;
+    }
+    if (run)
+      sizes[label[run_root]].fetch_add(run, std::memory_order_relaxed);
+  });
+  pool.parallel_for(0, n, [&](size_t lo, size_t hi) {
+    for (size_t v = lo; v < hi; ++v) {
+      const VertexId root = comp[v].load(std::memory_order_relaxed);
+      if (root != v && label[v] != PeakStore::INVALID_VERTEX_ID)
+        label[v] = label[root];
+    }
+  });
+  result.sizes.resize(count);
+  for (size_t c = 0; c < count; ++c)
+    result.sizes[c] = sizes[c].load(std::memory_order_relaxed);
+  return result;
+}
+
+} // namespace Algorithms
+} // namespace CinderPeak
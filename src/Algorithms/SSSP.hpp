@@ -0,0 +1,224 @@
+#pragma once
+#include "Concurrency/ThreadPool.hpp"
+#include "StorageEngine/CsrSnapshot.hpp"
+#include "StorageEngine/ErrorCodes.hpp"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+namespace CinderPeak {
+namespace Algorithms {
+
+using PeakStore::CsrSnapshot;
+using PeakStore::VertexId;
+
+struct SsspOptions {
+  // Bucket width. 0 picks max_weight / average_degree, the width Meyer and
+  // Sanders suggest for random weights; integer weights use at least 1.
+  double delta = 0.0;
+  // Graphs with fewer edges, or pools with a single thread, are solved with
+  // a binary-heap Dijkstra instead.
+  size_t dijkstra_below_edges = size_t{1} << 16;
+};
+
+// Distances indexed by VertexId; UNREACHABLE for vertices the source does
+// not reach.
+template <typename EdgeType> struct SsspResult {
+  static constexpr EdgeType UNREACHABLE =
+      std::numeric_limits<EdgeType>::has_infinity
+          ? std::numeric_limits<EdgeType>::infinity()
+          : std::numeric_limits<EdgeType>::max();
+  std::vector<EdgeType> distances;
+  size_t reached = 0;
+};
+
+namespace detail {
+
+template <typename EdgeType>
+void dijkstra(const CsrSnapshot<EdgeType> &graph, VertexId source,
+              std::vector<EdgeType> &distance) {
+  const size_t *offsets = graph.offsets();
+  const VertexId *cols = graph.cols();
+  const EdgeType *weights = graph.weightData();
+  using Entry = std::pair<EdgeType, VertexId>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+  distance[source] = EdgeType{};
+  heap.emplace(EdgeType{}, source);
+  while (!heap.empty()) {
+    const auto [d, u] = heap.top();
+    heap.pop();
+    if (d > distance[u])
+      continue; // stale entry
+    for (size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+      const EdgeType next = d + weights[e];
+      if (next < distance[cols[e]]) {
+        distance[cols[e]] = next;
+        heap.emplace(next, cols[e]);
+      }
+    }
+  }
+}
+
+// Parallel delta-stepping. Bucket b holds vertices whose tentative distance
+// lies in [b * delta, (b + 1) * delta). Each round drains the lowest
+// non-empty bucket on the pool, split by the degrees of its vertices. Tasks
+// lower distances with a CAS and collect the vertices they improved in
+// private buckets. Work that falls back into the current bucket is drained
+// in place while it stays small, saving a round trip through the shared
+// buckets. The rest is merged into the shared buckets once the task is
+// done. A vertex may sit in several buckets at once; entries whose distance
+// has since moved below their bucket are skipped.
+template <typename EdgeType>
+void deltaStepping(const CsrSnapshot<EdgeType> &graph, VertexId source,
+                   Concurrency::ThreadPool &pool, double delta,
+                   std::vector<EdgeType> &distance) {
+  constexpr size_t FUSE_BELOW = 1024;
+  const size_t n = graph.numVertices();
+  const size_t *offsets = graph.offsets();
+  const VertexId *cols = graph.cols();
+  const EdgeType *weights = graph.weightData();
+  std::unique_ptr<std::atomic<EdgeType>[]> dist(new std::atomic<EdgeType>[n]);
+  pool.parallel_for(0, n, [&](size_t lo, size_t hi) {
+    for (size_t v = lo; v < hi; ++v)
+      dist[v].store(SsspResult<EdgeType>::UNREACHABLE,
+                    std::memory_order_relaxed);
+  });
+  dist[source].store(EdgeType{}, std::memory_order_relaxed);
+  auto bucketOf = [delta](EdgeType d) {
+    return static_cast<size_t>(static_cast<double>(d) / delta);
+  };
+
+  std::vector<std::vector<VertexId>> buckets(1, {source});
+  std::mutex buckets_mutex;
+  std::vector<VertexId> frontier;
+  std::vector<size_t> work;
+  for (size_t b = 0;; ++b) {
+    while (b < buckets.size() && buckets[b].empty())
+      ++b;
+    if (b == buckets.size())
+      break;
+    // The same bucket is drained again until no task refills it.
+    for (;;) {
+      frontier.swap(buckets[b]);
+      buckets[b].clear();
+      if (frontier.empty())
+        break;
+      work.assign(frontier.size() + 1, 0);
+      for (size_t i = 0; i < frontier.size(); ++i)
+        work[i + 1] = work[i] + offsets[frontier[i] + 1] -
+                      offsets[frontier[i]] + 1;
+      pool.parallel_for_weighted(
+          0, frontier.size(), [&](size_t i) { return work[i]; },
+          [&](size_t lo, size_t hi) {
+            // local[k] collects bucket b + k.
+            std::vector<std::vector<VertexId>> local(1);
+            auto relax = [&](VertexId u) {
+              const EdgeType du = dist[u].load(std::memory_order_relaxed);
+              if (bucketOf(du) != b)
+                return;
+              for (size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+                const EdgeType next = du + weights[e];
+                EdgeType old = dist[cols[e]].load(std::memory_order_relaxed);
+                while (next < old &&
+                       !dist[cols[e]].compare_exchange_weak(
+                           old, next, std::memory_order_relaxed))
+                  ;
+                if (next < old) {
+                  const size_t k = bucketOf(next) - b;
+                  if (k >= local.size())
+                    local.resize(k + 1);
+                  local[k].push_back(cols[e]);
+                }
+              }
+            };
+            for (size_t i = lo; i < hi; ++i)
+              relax(frontier[i]);
+            std::vector<VertexId> fused;
+            while (!local[0].empty() && local[0].size() < FUSE_BELOW) {
+              fused.swap(local[0]);
+              local[0].clear();
+              for (VertexId u : fused)
+                relax(u);
+            }
+            std::lock_guard<std::mutex> lock(buckets_mutex);
+            if (buckets.size() < b + local.size())
+              buckets.resize(b + local.size());
+            for (size_t k = 0; k < local.size(); ++k)
+              buckets[b + k].insert(buckets[b + k].end(), local[k].begin(),
+                                    local[k].end());
+          });
+    }
+    std::vector<VertexId>().swap(buckets[b]);
+  }
+  pool.parallel_for(0, n, [&](size_t lo, size_t hi) {
+    for (size_t v = lo; v < hi; ++v)
+      distance[v] = dist[v].load(std::memory_order_relaxed);
+  });
+}
+
+} // namespace detail
+
+// Single-source shortest paths over the weighted out-edges of `graph`.
+// Fails with InvalidArgument, before any work, if a weight is negative or
+// the snapshot carries no weights. Integer distances are summed in
+// EdgeType and must not overflow it.
+template <typename EdgeType>
+std::pair<SsspResult<EdgeType>, PeakStatus>
+sssp(const CsrSnapshot<EdgeType> &graph, VertexId source,
+     Concurrency::ThreadPool &pool, const SsspOptions &options = {}) {
+  static_assert(std::is_arithmetic_v<EdgeType>,
+                "shortest paths need an arithmetic EdgeType");
+  const size_t n = graph.numVertices();
+  const size_t m = graph.numEdges();
+  SsspResult<EdgeType> result;
+  if (!graph.hasWeights())
+    return {result, PeakStatus::InvalidArgument("Graph has no edge weights")};
+
+  const EdgeType *weights = graph.weightData();
+  std::mutex max_mutex;
+  EdgeType max_weight{};
+  std::atomic<bool> negative{false};
+  pool.parallel_for(0, m, [&](size_t lo, size_t hi) {
+    EdgeType local_max{};
+    for (size_t e = lo; e < hi; ++e) {
+      if (weights[e] < EdgeType{})
+        negative.store(true, std::memory_order_relaxed);
+      local_max = std::max(local_max, weights[e]);
+    }
+    std::lock_guard<std::mutex> lock(max_mutex);
+    max_weight = std::max(max_weight, local_max);
+  });
+  if (negative.load(std::memory_order_relaxed))
+    return {result, PeakStatus::InvalidArgument("Negative edge weight")};
+
+  result.distances.assign(n, SsspResult<EdgeType>::UNREACHABLE);
+  if (source >= n)
+    return {result, PeakStatus::OK()};
+  if (m < options.dijkstra_below_edges || pool.size() == 1) {
+    detail::dijkstra(graph, source, result.distances);
+  } else {
+    double delta = options.delta;
+    if (delta <= 0) {
+      const double average_degree =
+          std::max(1.0, static_cast<double>(m) / static_cast<double>(n));
+      delta = static_cast<double>(max_weight) / average_degree;
+    }
+    if (std::is_integral_v<EdgeType> || delta <= 0)
+      delta = std::max(delta, 1.0);
+    detail::deltaStepping(graph, source, pool, delta, result.distances);
+  }
+  result.reached = static_cast<size_t>(std::count_if(
+      result.distances.begin(), result.distances.end(), [](EdgeType d) {
+        return d != SsspResult<EdgeType>::UNREACHABLE;
+      }));
+  return {std::move(result), PeakStatus::OK()};
+}
+
+} // namespace Algorithms
+} // namespace CinderPeak
@@ -0,0 +1,296 @@
+#pragma once
+#include "Concurrency/ThreadPool.hpp"
+#include "StorageEngine/CsrSnapshot.hpp"
+#include "StorageEngine/MatrixBlock.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+namespace CinderPeak {
+namespace Algorithms {
+
+using PeakStore::CsrSnapshot;
+using PeakStore::VertexId;
+
+struct TriangleOptions {
+  // Per-vertex triangle counts and local clustering coefficients. Turning
+  // them off leaves only the totals and spares an atomic add per triangle.
+  bool local = true;
+  // Set when every edge is stored in both directions, so that out-edges
+  // already are the undirected neighbors and no transpose is needed.
+  bool symmetric = false;
+};
+
+// Counts over the simple undirected graph underneath the snapshot: edge
+// directions, parallel edges and self loops are ignored. The vectors are
+// indexed by VertexId and empty unless TriangleOptions::local is set.
+struct TriangleResult {
+  std::uint64_t triangles = 0;
+  // 3 * triangles / connected triples, or 0 without any triple.
+  double transitivity = 0.0;
+  std::vector<std::uint64_t> per_vertex;
+  // Fraction of a vertex's neighbor pairs that are adjacent; 0 below
+  // degree 2.
+  std::vector<double> clustering;
+};
+
+namespace detail {
+
+// Calls visit(v) for each undirected neighbor of v once, in ascending order,
+// by merging its out-row with its in-row. `in_cols` is null for symmetric
+// graphs.
+template <typename Visit>
+inline void forEachUndirected(VertexId v, const size_t *offsets,
+                              const VertexId *cols, const size_t *in_offsets,
+                              const VertexId *in_cols, Visit &&visit) {
+  size_t i = offsets[v], j = in_cols ? in_offsets[v] : 0;
+  const size_t i_end = offsets[v + 1], j_end = in_cols ? in_offsets[v + 1] : 0;
+  VertexId last = v;
+  while (i < i_end || j < j_end) {
+    const VertexId w =
+        j == j_end || (i < i_end && cols[i] <= in_cols[j]) ? cols[i++]
+                                                           : in_cols[j++];
+    if (w != last && w != v)
+      visit(w);
+    last = w;
+  }
+}
+
+// Galloping intersection for rows of very different lengths: every element
+// of the short row is found in the long one by an exponential search from
+// the previous match.
+template <typename Visit>
+inline size_t gallopIntersect(const VertexId *a, size_t na, const VertexId *b,
+                              size_t nb, Visit &visit) {
+  size_t count = 0, j = 0;
+  for (size_t i = 0; i < na && j < nb; ++i) {
+    size_t bound = 1;
+    while (j + bound < nb && b[j + bound] < a[i])
+      bound *= 2;
+    j = static_cast<size_t>(std::lower_bound(b + j + bound / 2,
+                                             b + std::min(nb, j + bound + 1),
+                                             a[i]) -
+                            b);
+    if (j < nb && b[j] == a[i]) {
+      visit(a[i]);
+      ++count;
+      ++j;
+    }
+  }
+  return count;
+}
+
+// Calls visit(w) for every w in both sorted, duplicate-free ranges and
+// returns how many there were. On SSE2 targets with 32-bit ids, blocks of
+// four are compared all-against-all with three lane rotations; whichever
+// block has the smaller maximum is then replaced. The tail, 64-bit ids and
+// targets without SSE2 use a branch-free merge.
+template <typename Visit>
+inline size_t intersectSorted(const VertexId *a, size_t na, const VertexId *b,
+                              size_t nb, Visit &&visit) {
+  constexpr size_t GALLOP_RATIO = 32;
+  if (na > nb) {
+    std::swap(a, b);
+    std::swap(na, nb);
+  }
+  if (na * GALLOP_RATIO < nb)
+    return gallopIntersect(a, na, b, nb, visit);
+  size_t i = 0, j = 0, count = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+  if constexpr (sizeof(VertexId) == 4) {
+    while (i + 4 <= na && j + 4 <= nb) {
+      const __m128i va =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+      const __m128i vb =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j));
+      const __m128i rot1 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+      const __m128i rot2 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2));
+      const __m128i rot3 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3));
+      const __m128i eq = _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, rot1)),
+          _mm_or_si128(_mm_cmpeq_epi32(va, rot2),
+                       _mm_cmpeq_epi32(va, rot3)));
+      auto mask = static_cast<std::uint64_t>(
+          _mm_movemask_ps(_mm_castsi128_ps(eq)));
+      count += PeakStore::countSetBits(mask);
+      for (; mask; mask &= mask - 1)
+        visit(a[i + PeakStore::countTrailingZeros(mask)]);
+      const VertexId a_max = a[i + 3], b_max = b[j + 3];
+      i += a_max <= b_max ? 4 : 0;
+      j += b_max <= a_max ? 4 : 0;
+    }
+  }
+#endif
+  while (i < na && j < nb) {
+    const VertexId x = a[i], y = b[j];
+    if (x == y) {
+      visit(x);
+      ++count;
+    }
+    i += x <= y;
+    j += y <= x;
+  }
+  return count;
+}
+
+} // namespace detail
+
+// Triangle counting by sorted-row intersection over a degree-ordered
+// orientation. Every undirected edge is kept once, pointing from the lower
+// to the higher degree endpoint (ties broken by id), so each triangle is
+// found exactly once, at its lowest-ranked vertex, and no oriented row is
+// longer than about sqrt(2m). Vertices are split across `pool` by their
+// intersection work. Rows of a non-symmetric snapshot are merged with
+// those of `transpose`, built on the pool when not given.
+template <typename EdgeType>
+TriangleResult
+countTriangles(const CsrSnapshot<EdgeType> &graph,
+               Concurrency::ThreadPool &pool,
+               const TriangleOptions &options = {},
+               const CsrSnapshot<EdgeType> *transpose = nullptr) {
+  const size_t n = graph.numVertices();
+  TriangleResult result;
+  if (options.local) {
+    result.per_vertex.assign(n, 0);
+    result.clustering.assign(n, 0.0);
+  }
+  if (n == 0)
+    return result;
+
+  std::optional<CsrSnapshot<EdgeType>> built_transpose;
+  if (!options.symmetric && !transpose) {
+    built_transpose.emplace(graph.transposed(pool));
+    transpose = &*built_transpose;
+  }
+  const size_t *offsets = graph.offsets();
+  const VertexId *cols = graph.cols();
+  const size_t *in_offsets =
+      options.symmetric ? nullptr : transpose->offsets();
+  const VertexId *in_cols = options.symmetric ? nullptr : transpose->cols();
+  auto neighbors = [&](VertexId v, auto &&visit) {
+    detail::forEachUndirected(v, offsets, cols, in_offsets, in_cols, visit);
+  };
+  auto by_rows = [&](size_t v) {
+    return offsets[v] + (in_offsets ? in_offsets[v] : 0) + v;
+  };
+
+  std::vector<size_t> degree(n);
+  pool.parallel_for_weighted(0, n, by_rows, [&](size_t lo, size_t hi) {
+    for (size_t v = lo; v < hi; ++v) {
+      size_t d = 0;
+      neighbors(static_cast<VertexId>(v), [&d](VertexId) { ++d; });
+      degree[v] = d;
+    }
+  });
+  auto ranks_below = [&degree](VertexId v, VertexId w) {
+    return degree[v] < degree[w] || (degree[v] == degree[w] && v < w);
+  };
+
+  // Oriented rows keep the id order of the merged rows.
+  std::vector<size_t> up_offsets(n + 1, 0);
+  pool.parallel_for_weighted(0, n, by_rows, [&](size_t lo, size_t hi) {
+    for (size_t v = lo; v < hi; ++v) {
+      const VertexId u = static_cast<VertexId>(v);
+      size_t d = 0;
+      neighbors(u, [&](VertexId w) { d += ranks_below(u, w); });
+      up_offsets[v + 1] = d;
+    }
+  });
+  for (size_t v = 0; v < n; ++v)
+    up_offsets[v + 1] += up_offsets[v];
+  std::vector<VertexId> up_cols(up_offsets[n]);
+  pool.parallel_for_weighted(0, n, by_rows, [&](size_t lo, size_t hi) {
+    for (size_t v = lo; v < hi; ++v) {
+      const VertexId u = static_cast<VertexId>(v);
+      size_t out = up_offsets[v];
+      neighbors(u, [&](VertexId w) {
+        if (ranks_below(u, w))
+          up_cols[out++] = w;
+      });
+    }
+  });
+  built_transpose.reset();
+
+  // Intersecting u's row with each of its successors' rows costs about the
+  // sum of their lengths.
+  std::vector<size_t> work(n + 1, 0);
+  pool.parallel_for(0, n, [&](size_t lo, size_t hi) {
+    for (size_t u = lo; u < hi; ++u) {
+      size_t w = 1;
+      for (size_t e = up_offsets[u]; e < up_offsets[u + 1]; ++e)
+        w += up_offsets[u + 1] - up_offsets[u] + up_offsets[up_cols[e] + 1] -
+             up_offsets[up_cols[e]];
+      work[u + 1] = w;
+    }
+  });
+  for (size_t v = 0; v < n; ++v)
+    work[v + 1] += work[v];
+
+  std::unique_ptr<std::atomic<std::uint64_t>[]> through(
+      options.local ? new std::atomic<std::uint64_t>[n]() : nullptr);
+  std::atomic<std::uint64_t> total{0};
+  pool.parallel_for_weighted(
+      0, n, [&](size_t v) { return work[v]; },
+      [&](size_t lo, size_t hi) {
+        std::uint64_t local_total = 0;
+        for (size_t u = lo; u < hi; ++u) {
+          const VertexId *row = up_cols.data() + up_offsets[u];
+          const size_t length = up_offsets[u + 1] - up_offsets[u];
+          std::uint64_t at_u = 0;
+          for (size_t e = 0; e < length; ++e) {
+            const VertexId v = row[e];
+            const VertexId *other = up_cols.data() + up_offsets[v];
+            const size_t other_length = up_offsets[v + 1] - up_offsets[v];
+            if (!options.local) {
+              at_u += detail::intersectSorted(row, length, other, other_length,
+                                              [](VertexId) {});
+              continue;
+            }
+            const size_t found = detail::intersectSorted(
+                row, length, other, other_length, [&](VertexId w) {
+                  through[w].fetch_add(1, std::memory_order_relaxed);
+                });
+            if (found)
+              through[v].fetch_add(found, std::memory_order_relaxed);
+            at_u += found;
+          }
+          if (options.local && at_u)
+            through[u].fetch_add(at_u, std::memory_order_relaxed);
+          local_total += at_u;
+        }
+        total.fetch_add(local_total, std::memory_order_relaxed);
+      });
+  result.triangles = total.load(std::memory_order_relaxed);
+
+  std::mutex sum_mutex;
+  double triples = 0;
+  pool.parallel_for(0, n, [&](size_t lo, size_t hi) {
+    double local_triples = 0;
+    for (size_t v = lo; v < hi; ++v) {
+      const double pairs =
+          static_cast<double>(degree[v]) *
+          static_cast<double>(degree[v] ? degree[v] - 1 : 0) / 2;
+      local_triples += pairs;
+      if (options.local) {
+        result.per_vertex[v] = through[v].load(std::memory_order_relaxed);
+        if (pairs > 0)
+          result.clustering[v] =
+              static_cast<double>(result.per_vertex[v]) / pairs;
+      }
+    }
+    std::lock_guard<std::mutex> lock(sum_mutex);
+    triples += local_triples;
+  });
+  if (triples > 0)
+    result.transitivity = 3.0 * static_cast<double>(result.triangles) / triples;
+  return result;
+}
+
+} // namespace Algorithms
+} // namespace CinderPeak
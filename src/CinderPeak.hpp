@@ -13,12 +13,9 @@
 // #include "Visualizer.hpp"
 
 namespace CinderPeak {
-namespace PeakStore {
-template <typename VertexType, typename EdgeType> class PeakStore;
-}
-
 template <typename VertexType, typename EdgeType> class GraphMatrix;
-template <typename VertexType, typename EdgeType> class GraphList;
+template <typename VertexType, typename EdgeType, typename StoragePolicy>
+class GraphList;
 
 // class CinderGraph
 // {
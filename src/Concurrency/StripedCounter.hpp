@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+namespace CinderPeak {
+namespace Concurrency {
+
+// A small per-thread number for spreading writers across stripes. Threads
+// are numbered in creation order, so up to `stripes` threads never share.
+inline size_t threadStripe(size_t stripes) {
+  static std::atomic<size_t> next{0};
+  static thread_local const size_t index =
+      next.fetch_add(1, std::memory_order_relaxed);
+  return index % stripes;
+}
+
+// A counter that many threads can bump without sharing a cache line. Each
+// thread adds to one of STRIPES padded slots, picked once per thread, and
+// reads sum the slots. Increments are relaxed, so a read that overlaps
+// writers sees some interleaving of them; once the writers are done the sum
+// is exact. Slots wrap modulo 2^64, so sub() may leave a single slot
+// "negative" while the total stays correct.
+class StripedCounter {
+public:
+  StripedCounter(size_t value = 0) { store(value); }
+  StripedCounter(const StripedCounter &other) { store(other.load()); }
+  StripedCounter &operator=(const StripedCounter &other) {
+    store(other.load());
+    return *this;
+  }
+
+  void add(size_t n = 1) {
+    slots[threadStripe(STRIPES)].value.fetch_add(n, std::memory_order_relaxed);
+  }
+  void sub(size_t n = 1) {
+    slots[threadStripe(STRIPES)].value.fetch_sub(n, std::memory_order_relaxed);
+  }
+  size_t load() const {
+    size_t sum = 0;
+    for (const auto &slot : slots)
+      sum += slot.value.load(std::memory_order_relaxed);
+    return sum;
+  }
+  // Not atomic with respect to concurrent add()/sub().
+  void store(size_t value) {
+    for (auto &slot : slots)
+      slot.value.store(0, std::memory_order_relaxed);
+    slots[0].value.store(value, std::memory_order_relaxed);
+  }
+  operator size_t() const { return load(); }
+
+private:
+  static constexpr size_t STRIPES = 32;
+  struct alignas(64) Slot {
+    std::atomic<size_t> value{0};
+  };
+  Slot slots[STRIPES];
+};
+
+} // namespace Concurrency
+} // namespace CinderPeak
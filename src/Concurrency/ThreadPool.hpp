@@ -0,0 +1,272 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+namespace CinderPeak {
+namespace Concurrency {
+
+// Work-stealing pool shared by the storage engines and graph kernels. Every
+// thread of the pool owns a deque: it pushes and pops its own tasks at the
+// back and steals from the front of the other deques when it runs dry, so
+// recently split (small, cache-warm) work stays local and large, old chunks
+// migrate. A pool of size N runs N - 1 background workers; the thread that
+// waits on a TaskGroup runs queued tasks instead of blocking and counts as
+// the N-th, which also lets fork/join nest without deadlocking.
+class ThreadPool {
+public:
+  // Tracks a set of tasks. wait() helps run queued work until every task of
+  // the group has finished, then rethrows the first exception one of them
+  // raised.
+  class TaskGroup {
+  public:
+    explicit TaskGroup(ThreadPool &pool) : pool(pool) {}
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+    ~TaskGroup() {
+      // Tasks refer to the group, so they must finish before it goes away.
+      while (pending.load(std::memory_order_acquire) != 0)
+        pool.runPending();
+    }
+
+    template <typename Fn> void run(Fn &&fn) {
+      pending.fetch_add(1, std::memory_order_relaxed);
+      pool.push([this, fn = std::forward<Fn>(fn)]() mutable {
+        try {
+          fn();
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!error)
+            error = std::current_exception();
+        }
+        pending.fetch_sub(1, std::memory_order_release);
+      });
+    }
+    void wait() {
+      while (pending.load(std::memory_order_acquire) != 0)
+        pool.runPending();
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (error)
+        std::rethrow_exception(std::exchange(error, nullptr));
+    }
+
+  private:
+    ThreadPool &pool;
+    std::atomic<size_t> pending{0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+  };
+
+  static size_t defaultThreads() {
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+
+  explicit ThreadPool(size_t threads = defaultThreads()) {
+    threads = std::max<size_t>(1, threads);
+    for (size_t i = 0; i < threads; ++i)
+      queues.push_back(std::make_unique<Queue>());
+    // Queue 0 belongs to threads outside the pool.
+    for (size_t i = 1; i < threads; ++i)
+      workers.emplace_back([this, i] { workerLoop(i); });
+  }
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers)
+      worker.join();
+  }
+
+  size_t size() const { return queues.size(); }
+
+  // The process-wide pool used by graphs that do not bring their own.
+  // Callers keep the returned handle for as long as they use the pool, so
+  // setGlobalThreads() never pulls it out from under running work.
+  static std::shared_ptr<ThreadPool> global() {
+    std::lock_guard<std::mutex> lock(globalMutex());
+    auto &pool = globalSlot();
+    if (!pool)
+      pool = std::make_shared<ThreadPool>();
+    return pool;
+  }
+  static void setGlobalThreads(size_t threads) {
+    std::lock_guard<std::mutex> lock(globalMutex());
+    globalSlot() = std::make_shared<ThreadPool>(threads);
+  }
+
+  // Calls fn(lo, hi) on disjoint subranges that cover [begin, end). Ranges
+  // are halved until they hold at most `grain` items and the right halves
+  // are offered for stealing; grain 0 aims for about eight chunks per
+  // thread.
+  template <typename Fn>
+  void parallel_for(size_t begin, size_t end, Fn &&fn, size_t grain = 0) {
+    parallel_for_weighted(
+        begin, end, [](size_t i) { return i; }, std::forward<Fn>(fn), grain);
+  }
+  // Like parallel_for, but measures a range [lo, hi) by prefix(hi) -
+  // prefix(lo) for a non-decreasing `prefix` and splits it at the weight
+  // midpoint. With CSR row offsets plus the row index as the prefix, a hub
+  // row ends up in a chunk of its own instead of stalling the thread that
+  // drew it alongside many other rows.
+  template <typename Prefix, typename Fn>
+  void parallel_for_weighted(size_t begin, size_t end, Prefix &&prefix,
+                             Fn &&fn, size_t grain = 0) {
+    if (begin >= end)
+      return;
+    const size_t total = prefix(end) - prefix(begin);
+    if (grain == 0)
+      grain = std::max<size_t>(1, total / (8 * size()));
+    if (size() == 1 || total <= grain) {
+      fn(begin, end);
+      return;
+    }
+    TaskGroup group(*this);
+    split(group, begin, end, prefix, fn, grain);
+    group.wait();
+  }
+
+  // Runs both callables, `b` possibly on another thread, and returns once
+  // both have finished.
+  template <typename A, typename B> void fork_join(A &&a, B &&b) {
+    TaskGroup group(*this);
+    group.run(std::forward<B>(b));
+    a();
+    group.wait();
+  }
+
+private:
+  using Task = std::function<void()>;
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+  std::atomic<size_t> queued{0};
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+  bool stopping = false;
+
+  static inline thread_local const ThreadPool *current_pool = nullptr;
+  static inline thread_local size_t current_index = 0;
+
+  static std::mutex &globalMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+  static std::shared_ptr<ThreadPool> &globalSlot() {
+    static std::shared_ptr<ThreadPool> pool;
+    return pool;
+  }
+
+  size_t callerIndex() const {
+    return current_pool == this ? current_index : 0;
+  }
+
+  void push(Task task) {
+    Queue &queue = *queues[callerIndex()];
+    {
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      queue.tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1, std::memory_order_release);
+    // Pairs with the predicate check in workerLoop so no wakeup is lost.
+    { std::lock_guard<std::mutex> lock(sleep_mutex); }
+    wake.notify_one();
+  }
+
+  bool takeTask(size_t index, Task &task) {
+    {
+      Queue &own = *queues[index];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.tasks.empty()) {
+        task = std::move(own.tasks.back());
+        own.tasks.pop_back();
+        return true;
+      }
+    }
+    for (size_t i = 1; i < queues.size(); ++i) {
+      Queue &victim = *queues[(index + i) % queues.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Runs one queued task if there is any, otherwise yields.
+  void runPending() {
+    Task task;
+    if (queued.load(std::memory_order_acquire) != 0 &&
+        takeTask(callerIndex(), task)) {
+      queued.fetch_sub(1, std::memory_order_relaxed);
+      task();
+      return;
+    }
+    std::this_thread::yield();
+  }
+
+  void workerLoop(size_t index) {
+    current_pool = this;
+    current_index = index;
+    Task task;
+    for (;;) {
+      if (takeTask(index, task)) {
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        task();
+        task = nullptr;
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+      wake.wait(lock, [this] {
+        return stopping || queued.load(std::memory_order_acquire) != 0;
+      });
+      if (stopping && queued.load(std::memory_order_acquire) == 0)
+        return;
+    }
+  }
+
+  template <typename Prefix, typename Fn>
+  void split(TaskGroup &group, size_t lo, size_t hi, const Prefix &prefix,
+             const Fn &fn, size_t grain) {
+    while (hi - lo > 1 && prefix(hi) - prefix(lo) > grain) {
+      // Smallest split point whose prefix reaches the weight midpoint, kept
+      // strictly inside the range so both halves make progress.
+      const auto target = prefix(lo) + (prefix(hi) - prefix(lo)) / 2;
+      size_t left = lo + 1, right = hi - 1;
+      while (left < right) {
+        const size_t mid = left + (right - left) / 2;
+        if (prefix(mid) < target)
+          left = mid + 1;
+        else
+          right = mid;
+      }
+      const size_t mid = left;
+      group.run([this, &group, &prefix, &fn, mid, hi, grain] {
+        split(group, mid, hi, prefix, fn, grain);
+      });
+      hi = mid;
+    }
+    fn(lo, hi);
+  }
+};
+
+} // namespace Concurrency
+} // namespace CinderPeak
@@ -1,15 +1,33 @@
 #pragma once
+#include "Algorithms/BFS.hpp"
+#include "Algorithms/ConnectedComponents.hpp"
+#include "Algorithms/PageRank.hpp"
+#include "Algorithms/SSSP.hpp"
+#include "Algorithms/TriangleCount.hpp"
+#include "StorageEngine/GraphRanges.hpp"
+#include "StorageEngine/IngestPipeline.hpp"
+#include "StorageEngine/StoragePolicy.hpp"
+#include "StorageEngine/StoreStats.hpp"
 #include "StorageEngine/Utils.hpp"
 #include <iostream>
+#include <iterator>
+#include <tuple>
 namespace CinderPeak {
-namespace PeakStore {
-template <typename VertexType, typename EdgeType> class PeakStore;
-}
 class CinderGraph;
-template <typename VertexType, typename EdgeType> class GraphList {
+// StoragePolicy defaults to runtime-selected engines with adaptive
+// migration; PeakStore::StaticStorage<Engine> binds one engine at compile
+// time instead.
+template <typename VertexType, typename EdgeType,
+          typename StoragePolicy = PeakStore::DynamicStorage>
+class GraphList {
 private:
-  std::unique_ptr<CinderPeak::PeakStore::PeakStore<VertexType, EdgeType>>
-      peak_store;
+  using Store = CinderPeak::PeakStore::PeakStore<VertexType, EdgeType,
+                                                 StoragePolicy>;
+  std::unique_ptr<Store> peak_store;
+
+  Concurrency::ThreadPool &threadPool() const {
+    return *peak_store->getContext()->thread_pool;
+  }
 
 public:
   GraphList(const GraphCreationOptions &options =
@@ -17,9 +35,7 @@ public:
     CinderPeak::PeakStore::GraphInternalMetadata metadata(
         "graph_list", isTypePrimitive<VertexType>(),
         isTypePrimitive<EdgeType>());
-    peak_store = std::make_unique<
-        CinderPeak::PeakStore::PeakStore<VertexType, EdgeType>>(metadata,
-                                                                options);
+    peak_store = std::make_unique<Store>(metadata, options);
   }
 
   void addVertex(const VertexType &v) {
@@ -60,6 +76,68 @@ public:
     }
   }
 
+  // Adds the edge, or overwrites the weight if it already exists.
+  void updateEdge(const VertexType &src, const VertexType &dest,
+                  const EdgeType &weight) {
+    auto ctx = peak_store->getContext();
+    if (ctx->create_options->hasOption(GraphCreationOptions::Unweighted)) {
+      LOG_CRITICAL(
+          "Cannot call updateEdge on an unweighted graph, extra weight");
+      return;
+    }
+    auto [result, resp] = peak_store->upsertEdge(src, dest, weight);
+    if (!resp.isOK()) {
+      Exceptions::handle_exception_map(resp);
+      return;
+    }
+  }
+
+  template <typename Range> void addVertices(const Range &vertices) {
+    auto resp = peak_store->addVertices(vertices);
+    if (!resp.isOK()) {
+      Exceptions::handle_exception_map(resp);
+      return;
+    }
+  }
+
+  // Each element is a (src, dest) pair for unweighted graphs or a
+  // (src, dest, weight) tuple for weighted graphs.
+  template <typename Range> void addEdges(const Range &edges) {
+    using Edge = std::decay_t<decltype(*std::begin(edges))>;
+    auto ctx = peak_store->getContext();
+    if constexpr (std::tuple_size_v<Edge> < 3) {
+      if (ctx->create_options->hasOption(GraphCreationOptions::Weighted)) {
+        LOG_CRITICAL("Cannot call unweighted addEdges on a weighted graph, "
+                     "missing weight");
+        return;
+      }
+    } else {
+      if (ctx->create_options->hasOption(GraphCreationOptions::Unweighted)) {
+        LOG_CRITICAL("Cannot call weighted addEdges on an unweighted graph, "
+                     "extra weight");
+        return;
+      }
+    }
+    auto resp = peak_store->addEdges(edges);
+    if (!resp.isOK()) {
+      Exceptions::handle_exception_map(resp);
+      return;
+    }
+  }
+
+  // Bulk load: threads push edge batches into the returned pipeline, then a
+  // single commitIngest() merges them into the graph.
+  PeakStore::IngestPipeline<VertexType, EdgeType> beginIngest() const {
+    return peak_store->beginIngest();
+  }
+  void commitIngest(PeakStore::IngestPipeline<VertexType, EdgeType> &in) {
+    auto resp = peak_store->commitIngest(in);
+    if (!resp.isOK()) {
+      Exceptions::handle_exception_map(resp);
+      return;
+    }
+  }
+
   EdgeType getEdge(const VertexType &src, const VertexType &dest) {
     LOG_INFO("Called getEdge");
     auto [data, status] = peak_store->getEdge(src, dest);
@@ -70,6 +148,116 @@ public:
     return data;
   }
 
+  // Read-only view of the out-edges of `src`, iterable as (vertex, weight)
+  // pairs without copying. Invalidated by the next write to the graph.
+  PeakStore::NeighborView<VertexType, EdgeType>
+  neighbors(const VertexType &src) {
+    auto [view, status] = peak_store->neighbors(src);
+    if (!status.isOK()) {
+      Exceptions::handle_exception_map(status);
+      return {};
+    }
+    return view;
+  }
+  auto vertices() { return peak_store->vertices(); }
+  // Immutable CSR of the out-edges, indexed by vertexId(); the input of the
+  // kernels in Algorithms/.
+  PeakStore::CsrSnapshot<EdgeType> csrSnapshot() {
+    return peak_store->csrSnapshot();
+  }
+  // Dense id of `v` in algorithm results, or PeakStore::INVALID_VERTEX_ID.
+  PeakStore::VertexId vertexId(const VertexType &v) const {
+    return peak_store->vertexId(v);
+  }
+  const VertexType &vertexAt(PeakStore::VertexId id) const {
+    return peak_store->vertexAt(id);
+  }
+  // Parallel direction-optimizing BFS from `source` over out-edges. The
+  // result arrays are indexed by vertexId().
+  Algorithms::BfsResult bfs(const VertexType &source,
+                            const Algorithms::BfsOptions &options = {}) {
+    const auto graph = csrSnapshot();
+    const PeakStore::VertexId id = vertexId(source);
+    // An unknown source yields a result in which nothing is reached.
+    if (id >= graph.numVertices())
+      Exceptions::handle_exception_map(PeakStatus::VertexNotFound());
+    return Algorithms::bfs(graph, id, threadPool(), options);
+  }
+  // Weighted shortest-path distances from `source` along out-edges, indexed
+  // by vertexId(). Negative weights are rejected before any work is done.
+  Algorithms::SsspResult<EdgeType>
+  shortestPaths(const VertexType &source,
+                const Algorithms::SsspOptions &options = {}) {
+    auto ctx = peak_store->getContext();
+    if (ctx->create_options->hasOption(GraphCreationOptions::Unweighted)) {
+      LOG_CRITICAL("Cannot compute weighted shortest paths on an unweighted "
+                   "graph, use bfs");
+      return {};
+    }
+    const auto graph = csrSnapshot();
+    const PeakStore::VertexId id = vertexId(source);
+    if (id >= graph.numVertices())
+      Exceptions::handle_exception_map(PeakStatus::VertexNotFound());
+    auto [result, status] =
+        Algorithms::sssp(graph, id, threadPool(), options);
+    if (!status.isOK())
+      Exceptions::handle_exception_map(status);
+    return result;
+  }
+  // PageRank of every vertex, indexed by vertexId(); Real selects float or
+  // double rank arrays.
+  template <typename Real = double>
+  Algorithms::PageRankResult<Real>
+  pageRank(const Algorithms::PageRankOptions &options = {}) {
+    auto [result, status] =
+        Algorithms::pageRank<Real>(csrSnapshot(), threadPool(), options);
+    if (!status.isOK())
+      Exceptions::handle_exception_map(status);
+    return result;
+  }
+  // PageRank whose random jumps land uniformly on `seeds` only. Unknown
+  // seeds are reported and skipped.
+  template <typename Real = double>
+  Algorithms::PageRankResult<Real>
+  personalizedPageRank(const std::vector<VertexType> &seeds,
+                       const Algorithms::PageRankOptions &options = {}) {
+    const auto graph = csrSnapshot();
+    std::vector<double> personalization(graph.numVertices(), 0.0);
+    for (const auto &seed : seeds) {
+      const PeakStore::VertexId id = vertexId(seed);
+      if (id < graph.numVertices())
+        personalization[id] = 1.0;
+      else
+        Exceptions::handle_exception_map(PeakStatus::VertexNotFound());
+    }
+    auto [result, status] = Algorithms::pageRank<Real>(
+        graph, threadPool(), options, &personalization);
+    if (!status.isOK())
+      Exceptions::handle_exception_map(status);
+    return result;
+  }
+  // Weakly connected components, indexed by vertexId(). The in-edges come
+  // from a transpose built on the pool, so that Afforest can sample the
+  // giant component and skip it.
+  Algorithms::ComponentsResult
+  connectedComponents(const Algorithms::ComponentsOptions &options = {}) {
+    const auto graph = csrSnapshot();
+    const auto transpose = graph.transposed(threadPool());
+    return Algorithms::connectedComponents(graph, threadPool(), options,
+                                           &transpose);
+  }
+  // Triangle count, transitivity and, unless turned off in `options`,
+  // per-vertex triangles and clustering coefficients indexed by vertexId().
+  // Edge directions are ignored.
+  Algorithms::TriangleResult
+  triangles(const Algorithms::TriangleOptions &options = {}) {
+    return Algorithms::countTriangles(csrSnapshot(), threadPool(), options);
+  }
+  // Counters, memory use and, for Instrumented graphs, operation latencies.
+  PeakStore::StatsSnapshot stats() const { return peak_store->stats(); }
+  // Iterable as (src, dest, weight) tuples.
+  auto edges() { return peak_store->edges(); }
+
   void visualize() {
     LOG_INFO("Called GraphList:visualize");
     peak_store->visualize();
@@ -1,11 +1,13 @@
 #pragma once
+#include "Algorithms/ConnectedComponents.hpp"
+#include "StorageEngine/GraphRanges.hpp"
+#include "StorageEngine/StoragePolicy.hpp"
 #include "StorageEngine/Utils.hpp"
 #include <iostream>
+#include <iterator>
+#include <tuple>
 #include <memory>
 namespace CinderPeak {
-namespace PeakStore {
-template <typename VertexType, typename EdgeType> class PeakStore;
-}
 class CinderGraph;
 
 template <typename VertexType, typename EdgeType> class GraphMatrix;
@@ -30,7 +32,7 @@ public:
         : graph(g), src(s), dest(d) {}
 
     EdgeReference &operator=(const EdgeType &weight) {
-      graph.addEdge(src, dest, weight);
+      graph.updateEdge(src, dest, weight);
       return *this;
     }
     operator EdgeType() const { return graph.getEdge(src, dest); }
@@ -96,6 +98,55 @@ public:
     }
   }
 
+  // Adds the edge, or overwrites the weight if it already exists.
+  void updateEdge(const VertexType &src, const VertexType &dest,
+                  const EdgeType &weight) {
+    auto ctx = peak_store->getContext();
+    if (ctx->create_options->hasOption(GraphCreationOptions::Unweighted)) {
+      LOG_CRITICAL(
+          "Cannot call updateEdge on an unweighted graph, extra weight");
+      return;
+    }
+    auto [result, resp] = peak_store->upsertEdge(src, dest, weight);
+    if (!resp.isOK()) {
+      Exceptions::handle_exception_map(resp);
+      return;
+    }
+  }
+
+  template <typename Range> void addVertices(const Range &vertices) {
+    auto resp = peak_store->addVertices(vertices);
+    if (!resp.isOK()) {
+      Exceptions::handle_exception_map(resp);
+      return;
+    }
+  }
+
+  // Each element is a (src, dest) pair for unweighted graphs or a
+  // (src, dest, weight) tuple for weighted graphs.
+  template <typename Range> void addEdges(const Range &edges) {
+    using Edge = std::decay_t<decltype(*std::begin(edges))>;
+    auto ctx = peak_store->getContext();
+    if constexpr (std::tuple_size_v<Edge> < 3) {
+      if (ctx->create_options->hasOption(GraphCreationOptions::Weighted)) {
+        LOG_CRITICAL("Cannot call unweighted addEdges on a weighted graph, "
+                     "missing weight");
+        return;
+      }
+    } else {
+      if (ctx->create_options->hasOption(GraphCreationOptions::Unweighted)) {
+        LOG_CRITICAL("Cannot call weighted addEdges on a unweighted graph, "
+                     "extra weight");
+        return;
+      }
+    }
+    auto resp = peak_store->addEdges(edges);
+    if (!resp.isOK()) {
+      Exceptions::handle_exception_map(resp);
+      return;
+    }
+  }
+
   EdgeType getEdge(const VertexType &src, const VertexType &dest) const {
     auto [data, status] = peak_store->getEdge(src, dest);
     if (!status.isOK()) {
@@ -104,6 +155,48 @@ public:
     }
     return data;
   }
+  // Read-only view of the out-edges of `src`, iterable as (vertex, weight)
+  // pairs without copying. Invalidated by the next write to the graph.
+  PeakStore::NeighborView<VertexType, EdgeType>
+  neighbors(const VertexType &src) const {
+    auto [view, status] = peak_store->neighbors(src);
+    if (!status.isOK()) {
+      Exceptions::handle_exception_map(status);
+      return {};
+    }
+    return view;
+  }
+  PeakStore::VertexRange<VertexType, EdgeType> vertices() const {
+    return peak_store->vertices();
+  }
+  // Iterable as (src, dest, weight) tuples.
+  PeakStore::EdgeRange<VertexType, EdgeType> edges() const {
+    return peak_store->edges();
+  }
+
+  // Immutable CSR of the out-edges, indexed by vertexId(); the input of the
+  // kernels in Algorithms/.
+  PeakStore::CsrSnapshot<EdgeType> csrSnapshot() {
+    return peak_store->csrSnapshot();
+  }
+  // Dense id of `v` in algorithm results, or PeakStore::INVALID_VERTEX_ID.
+  PeakStore::VertexId vertexId(const VertexType &v) const {
+    return peak_store->vertexId(v);
+  }
+  const VertexType &vertexAt(PeakStore::VertexId id) const {
+    return peak_store->vertexAt(id);
+  }
+  // Weakly connected components, indexed by vertexId(). The in-edges come
+  // from a transpose built on the pool, so that Afforest can sample the
+  // giant component and skip it.
+  Algorithms::ComponentsResult
+  connectedComponents(const Algorithms::ComponentsOptions &options = {}) {
+    auto &pool = *peak_store->getContext()->thread_pool;
+    const auto graph = csrSnapshot();
+    const auto transpose = graph.transposed(pool);
+    return Algorithms::connectedComponents(graph, pool, options, &transpose);
+  }
+
   void visualize() { LOG_INFO("Called GraphMatrix:visualize"); }
 
   EdgeAccessor<VertexType, EdgeType> operator[](const VertexType &src) {
@@ -1,11 +1,18 @@
 #pragma once
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <ctime>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 // ANSI color codes
 #define COLOR_RESET "\033[0m"
@@ -25,22 +32,116 @@
 
 enum class LogLevel { TRACE, DEBUG, INFO, WARNING, ERROR, CRITICAL };
 
+// Lowest level compiled in: 0 = TRACE ... 5 = CRITICAL, 6 disables every
+// LOG_* macro. Calls below it expand to dead code, so their arguments are
+// never evaluated. Define it before including any CinderPeak header, e.g.
+// -DCINDERPEAK_LOG_LEVEL=3 to keep only warnings and errors.
+#ifndef CINDERPEAK_LOG_LEVEL
+#define CINDERPEAK_LOG_LEVEL 0
+#endif
+
+// What an asynchronous log call does when the ring buffer is full.
+enum class LogOverflow {
+  Drop,  // discard the record and count it in Logger::droppedRecords()
+  Block, // wait for the writer thread to make room
+};
+
 class Logger {
 public:
   inline static bool enableConsoleLogging = false;
   inline static bool enableFileLogging = false;
   inline static std::string logFileName = "peak_logs.log";
+  // Records below this level are skipped at runtime.
+  inline static LogLevel minLevel = LogLevel::TRACE;
+
+  // Checked by the LOG_* macros before their arguments are evaluated.
+  static bool shouldLog(LogLevel level) {
+    return (enableConsoleLogging || enableFileLogging) && level >= minLevel;
+  }
+
+  // Replaces each "{}" in `fmt` with the next argument, written with
+  // operator<<. Surplus arguments are ignored, surplus "{}" kept as is.
+  static std::string format(const std::string &fmt) { return fmt; }
+  template <typename Arg, typename... Args>
+  static std::string format(const std::string &fmt, const Arg &arg,
+                            const Args &...args) {
+    std::ostringstream out;
+    size_t pos = 0;
+    formatInto(out, fmt, pos, arg, args...);
+    out << fmt.substr(pos);
+    return out.str();
+  }
 
   static void log(LogLevel level, const std::string &msg) {
-    logImpl(level, msg, "", -1);
+    log(level, msg, static_cast<const char *>(nullptr), -1);
   }
 
   static void log(LogLevel level, const std::string &msg,
                   const std::string &file, int line) {
+    if (!shouldLog(level))
+      return;
+    // The path may not outlive the call, so a queued record carries the
+    // location inside its message.
+    if (isAsync() && !file.empty() && line != -1) {
+      if (enqueue(level, msg + " (" + file + ":" + std::to_string(line) + ")",
+                  nullptr, -1))
+        return;
+    }
     logImpl(level, msg, file, line);
   }
+  // Used by the LOG_* macros: __FILE__ outlives any queued record, so the
+  // asynchronous path can keep the pointer instead of copying the path.
+  static void log(LogLevel level, const std::string &msg, const char *file,
+                  int line) {
+    if (!shouldLog(level))
+      return;
+    if (!enqueue(level, msg, file, line))
+      logImpl(level, msg, file ? file : "", line);
+  }
+
+  // Hands records to a background writer instead of formatting and writing
+  // them on the calling thread. Callers only copy the message into a
+  // bounded lock-free ring of `capacity` records (rounded up to a power of
+  // two); the writer formats whole batches and writes them with buffered
+  // I/O, flushing once the ring runs dry. Records still queued when
+  // disableAsync() or shutdown() runs, or when the process exits, are
+  // written out first.
+  static void enableAsync(size_t capacity = 8192,
+                          LogOverflow overflow = LogOverflow::Drop) {
+    std::lock_guard<std::mutex> lock(asyncMutex);
+    if (asyncSink.load(std::memory_order_acquire))
+      return;
+    static const bool registered = [] {
+      std::atexit(shutdown);
+      return true;
+    }();
+    (void)registered;
+    asyncSink.store(new AsyncSink(capacity, overflow),
+                    std::memory_order_release);
+  }
+  static void disableAsync() {
+    std::lock_guard<std::mutex> lock(asyncMutex);
+    // Sequentially consistent, like the caller side in enqueue(): either the
+    // caller's increment is seen here or the caller sees the null sink.
+    // Acquire/release alone allows both loads to miss the other store.
+    AsyncSink *sink = asyncSink.exchange(nullptr, std::memory_order_seq_cst);
+    if (!sink)
+      return;
+    // A caller may have loaded the sink just before the exchange.
+    while (asyncCallers.load(std::memory_order_seq_cst) != 0)
+      std::this_thread::yield();
+    delete sink;
+  }
+  static bool isAsync() {
+    return asyncSink.load(std::memory_order_acquire) != nullptr;
+  }
+  // Records discarded under LogOverflow::Drop since async logging started.
+  static size_t droppedRecords() {
+    return dropped.load(std::memory_order_relaxed);
+  }
 
   static void shutdown() {
+    disableAsync();
     std::lock_guard<std::mutex> lock(logMutex);
     if (logFile.is_open()) {
       logFile.close();
@@ -48,8 +149,216 @@ public:
   }
 
 private:
+  struct Record {
+    LogLevel level;
+    std::chrono::system_clock::time_point time;
+    const char *file;
+    int line;
+    std::string msg;
+  };
+
+  // Bounded multi-producer ring (Vyukov's sequence-numbered cells) drained
+  // by a single writer thread.
+  class AsyncSink {
+  public:
+    AsyncSink(size_t capacity, LogOverflow overflow)
+        : mask(roundUp(capacity) - 1), overflow(overflow),
+          cells(new Cell[mask + 1]) {
+      for (size_t i = 0; i <= mask; ++i)
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+      writer = std::thread([this] { run(); });
+    }
+    ~AsyncSink() {
+      {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        stopping = true;
+      }
+      wake.notify_one();
+      writer.join();
+    }
+
+    void push(Record &&record) {
+      for (;;) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Cell &cell = cells[pos & mask];
+        const size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (seq == pos) {
+          if (tail.compare_exchange_weak(pos, pos + 1,
+                                         std::memory_order_relaxed)) {
+            cell.record = std::move(record);
+            cell.sequence.store(pos + 1, std::memory_order_release);
+            return;
+          }
+        } else if (seq < pos) {
+          if (overflow == LogOverflow::Drop) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+          }
+          wake.notify_one();
+          std::this_thread::yield();
+        }
+      }
+    }
+
+  private:
+    struct Cell {
+      std::atomic<size_t> sequence;
+      Record record;
+    };
+
+    const size_t mask;
+    const LogOverflow overflow;
+    std::unique_ptr<Cell[]> cells;
+    std::atomic<size_t> tail{0};
+    size_t head = 0; // writer thread only
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread writer;
+
+    static size_t roundUp(size_t n) {
+      size_t p = 2;
+      while (p < n)
+        p <<= 1;
+      return p;
+    }
+
+    bool pop(Record &record) {
+      Cell &cell = cells[head & mask];
+      if (cell.sequence.load(std::memory_order_acquire) != head + 1)
+        return false;
+      record = std::move(cell.record);
+      cell.sequence.store(head + mask + 1, std::memory_order_release);
+      ++head;
+      return true;
+    }
+
+    void run() {
+      std::vector<Record> batch;
+      TimestampCache stamp;
+      for (;;) {
+        Record record;
+        while (batch.size() < 1024 && pop(record))
+          batch.push_back(std::move(record));
+        if (!batch.empty()) {
+          writeBatch(batch, stamp);
+          batch.clear();
+          continue;
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        if (stopping)
+          return;
+        // Producers never signal, so poll at a short interval.
+        wake.wait_for(lock, std::chrono::milliseconds(5));
+      }
+    }
+  };
+
+  // Formats "YYYY-mm-dd HH:MM:SS" once per second instead of per record.
+  struct TimestampCache {
+    std::time_t second = -1;
+    std::string prefix;
+
+    std::string format(std::chrono::system_clock::time_point time) {
+      const std::time_t t_c = std::chrono::system_clock::to_time_t(time);
+      if (t_c != second) {
+        std::ostringstream oss;
+        oss << std::put_time(std::localtime(&t_c), "%Y-%m-%d %H:%M:%S");
+        prefix = oss.str();
+        second = t_c;
+      }
+      const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          time.time_since_epoch())
+                          .count() %
+                      1000;
+      std::string out = prefix;
+      out += '.';
+      out += static_cast<char>('0' + ms / 100);
+      out += static_cast<char>('0' + ms / 10 % 10);
+      out += static_cast<char>('0' + ms % 10);
+      return out;
+    }
+  };
+
   inline static std::mutex logMutex;
   inline static std::ofstream logFile;
+  inline static std::mutex asyncMutex;
+  inline static std::atomic<AsyncSink *> asyncSink{nullptr};
+  inline static std::atomic<size_t> asyncCallers{0};
+  inline static std::atomic<size_t> dropped{0};
+
+  static void formatInto(std::ostringstream &, const std::string &,
+                         size_t &) {}
+  template <typename Arg, typename... Args>
+  static void formatInto(std::ostringstream &out, const std::string &fmt,
+                         size_t &pos, const Arg &arg, const Args &...args) {
+    const size_t hole = fmt.find("{}", pos);
+    if (hole == std::string::npos)
+      return;
+    out << fmt.substr(pos, hole - pos) << arg;
+    pos = hole + 2;
+    formatInto(out, fmt, pos, args...);
+  }
+
+  static bool enqueue(LogLevel level, const std::string &msg,
+                      const char *file, int line) {
+    if (!asyncSink.load(std::memory_order_relaxed))
+      return false;
+    asyncCallers.fetch_add(1, std::memory_order_seq_cst);
+    AsyncSink *sink = asyncSink.load(std::memory_order_seq_cst);
+    if (sink)
+      sink->push({level, std::chrono::system_clock::now(), file, line, msg});
+    asyncCallers.fetch_sub(1, std::memory_order_release);
+    return sink != nullptr;
+  }
+
+  // Writes a batch to the enabled sinks with one flush per sink.
+  static void writeBatch(const std::vector<Record> &batch,
+                         TimestampCache &stamp) {
+    std::string console, file;
+    for (const auto &record : batch) {
+      const std::string timestamp = stamp.format(record.time);
+      const char *levelStr = levelToString(record.level);
+      const bool located = record.file && record.line != -1;
+      if (enableConsoleLogging) {
+        console.append(COLOR_BOLD_WHITE "[" COLOR_RESET)
+            .append(timestamp)
+            .append(COLOR_BOLD_WHITE "] [" COLOR_RESET)
+            .append(levelToColor(record.level))
+            .append(levelStr)
+            .append(COLOR_RESET COLOR_BOLD_WHITE "]" COLOR_RESET " ")
+            .append(record.msg);
+        if (located) {
+          console.append(COLOR_WHITE " (")
+              .append(record.file)
+              .append(":")
+              .append(std::to_string(record.line))
+              .append(")" COLOR_RESET);
+        }
+        console += '\n';
+      }
+      if (enableFileLogging) {
+        file.append("[").append(timestamp).append("] [").append(levelStr);
+        file.append("] ").append(record.msg);
+        if (located) {
+          file.append(" (")
+              .append(record.file)
+              .append(":")
+              .append(std::to_string(record.line))
+              .append(")");
+        }
+        file += '\n';
+      }
+    }
+    std::lock_guard<std::mutex> lock(logMutex);
+    if (!console.empty())
+      std::cerr.write(console.data(), console.size()).flush();
+    if (!file.empty()) {
+      ensureFileOpen();
+      if (logFile.is_open())
+        logFile.write(file.data(), file.size()).flush();
+    }
+  }
 
   static const char *levelToString(LogLevel level) {
     switch (level) {
@@ -110,7 +419,7 @@ private:
 
   static void logImpl(LogLevel level, const std::string &msg,
                       const std::string &file, int line) {
-    if (!enableConsoleLogging && !enableFileLogging)
+    if (!shouldLog(level))
       return;
 
     std::lock_guard<std::mutex> lock(logMutex);
@@ -148,10 +457,57 @@ private:
   }
 };
 
-#define LOG_TRACE(msg) Logger::log(LogLevel::TRACE, msg)
-#define LOG_DEBUG(msg) Logger::log(LogLevel::DEBUG, msg)
-#define LOG_INFO(msg) Logger::log(LogLevel::INFO, msg)
-#define LOG_WARNING(msg) Logger::log(LogLevel::WARNING, msg, __FILE__, __LINE__)
-#define LOG_ERROR(msg) Logger::log(LogLevel::ERROR, msg, __FILE__, __LINE__)
-#define LOG_CRITICAL(msg)                                                      \
-  Logger::log(LogLevel::CRITICAL, msg, __FILE__, __LINE__)
\ No newline at end of file
+// Every macro takes a message or a "{}" format string plus arguments, e.g.
+// LOG_DEBUG("added edge {} -> {}", src, dest). Nothing past the level check
+// is evaluated unless the record will be written.
+#define CINDERPEAK_LOG(level, file, line, ...)                                 \
+  do {                                                                         \
+    if (Logger::shouldLog(level))                                              \
+      Logger::log(level, Logger::format(__VA_ARGS__), file, line);            \
+  } while (0)
+// Keeps compiled-out calls type-checked without evaluating them.
+#define CINDERPEAK_LOG_DISABLED(...)                                           \
+  do {                                                                         \
+    if (false)                                                                 \
+      (void)Logger::format(__VA_ARGS__);                                       \
+  } while (0)
+
+#if CINDERPEAK_LOG_LEVEL <= 0
+#define LOG_TRACE(...)                                                         \
+  CINDERPEAK_LOG(LogLevel::TRACE, static_cast<const char *>(nullptr), -1,      \
+                 __VA_ARGS__)
+#else
+#define LOG_TRACE(...) CINDERPEAK_LOG_DISABLED(__VA_ARGS__)
+#endif
+#if CINDERPEAK_LOG_LEVEL <= 1
+#define LOG_DEBUG(...)                                                         \
+  CINDERPEAK_LOG(LogLevel::DEBUG, static_cast<const char *>(nullptr), -1,      \
+                 __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) CINDERPEAK_LOG_DISABLED(__VA_ARGS__)
+#endif
+#if CINDERPEAK_LOG_LEVEL <= 2
+#define LOG_INFO(...)                                                          \
+  CINDERPEAK_LOG(LogLevel::INFO, static_cast<const char *>(nullptr), -1,       \
+                 __VA_ARGS__)
+#else
+#define LOG_INFO(...) CINDERPEAK_LOG_DISABLED(__VA_ARGS__)
+#endif
+#if CINDERPEAK_LOG_LEVEL <= 3
+#define LOG_WARNING(...)                                                       \
+  CINDERPEAK_LOG(LogLevel::WARNING, __FILE__, __LINE__, __VA_ARGS__)
+#else
+#define LOG_WARNING(...) CINDERPEAK_LOG_DISABLED(__VA_ARGS__)
+#endif
+#if CINDERPEAK_LOG_LEVEL <= 4
+#define LOG_ERROR(...)                                                         \
+  CINDERPEAK_LOG(LogLevel::ERROR, __FILE__, __LINE__, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) CINDERPEAK_LOG_DISABLED(__VA_ARGS__)
+#endif
+#if CINDERPEAK_LOG_LEVEL <= 5
+#define LOG_CRITICAL(...)                                                      \
+  CINDERPEAK_LOG(LogLevel::CRITICAL, __FILE__, __LINE__, __VA_ARGS__)
+#else
+#define LOG_CRITICAL(...) CINDERPEAK_LOG_DISABLED(__VA_ARGS__)
+#endif
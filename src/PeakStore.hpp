@@ -1,38 +1,394 @@
 #pragma once
 #include "CinderPeak.hpp"
+#include "StorageEngine/AdaptiveStorage.hpp"
 #include "StorageEngine/AdjacencyList.hpp"
+#include "StorageEngine/AdjacencyMatrix.hpp"
+#include "StorageEngine/CsrSnapshot.hpp"
 #include "StorageEngine/ErrorCodes.hpp"
 #include "StorageEngine/GraphContext.hpp"
+#include "StorageEngine/GraphRanges.hpp"
 #include "StorageEngine/HybridCSR_COO.hpp"
+#include "StorageEngine/IngestPipeline.hpp"
+#include "StorageEngine/StoragePolicy.hpp"
 #include "StorageEngine/Utils.hpp"
+#include "StorageEngine/VertexDictionary.hpp"
 // #include "Visualizer.hpp"
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 namespace CinderPeak {
 template <typename VertexType, typename EdgeType> class GraphVisualizer;
 namespace PeakStore {
 
-template <typename VertexType, typename EdgeType> class PeakStore {
+template <typename VertexType, typename EdgeType, typename StoragePolicy>
+class PeakStore {
+public:
+  using Engine =
+      typename storage_engine<StoragePolicy, VertexType, EdgeType>::type;
+  static constexpr bool is_static_storage =
+      storage_engine<StoragePolicy, VertexType, EdgeType>::is_static;
+
 private:
+  using EdgeBatch =
+      typename PeakStorageInterface<VertexType, EdgeType>::EdgeBatch;
+
   std::shared_ptr<GraphContext<VertexType, EdgeType>> ctx = nullptr;
+  // Under StaticStorage the engine lives here instead of in the context.
+  std::conditional_t<is_static_storage, std::optional<Engine>, std::nullptr_t>
+      static_engine{};
+
+  Engine &storage() {
+    if constexpr (is_static_storage)
+      return *static_engine;
+    else
+      return *ctx->active_storage;
+  }
+  const Engine &storage() const {
+    if constexpr (is_static_storage)
+      return *static_engine;
+    else
+      return *ctx->active_storage;
+  }
+
+  // Adaptive storage state. Only graph_list stores migrate. Const reads
+  // only count themselves, hence the mutable tracker; the engines are
+  // switched on writes and in maintain().
+  bool adaptive_eligible = false;
+  // Set by GraphCreationOptions::Concurrent. Concurrent stores stay on the
+  // sharded adjacency list and skip workload tracking and migration.
+  bool concurrent = false;
+  AdaptiveStoragePolicy adaptive_policy;
+  StorageKind active_kind = StorageKind::AdjacencyList;
+  mutable WorkloadTracker workload;
+  std::shared_ptr<HybridCSR_COO<VertexType, EdgeType>> pending_hybrid;
+  std::shared_ptr<AdjacencyList<VertexType, EdgeType>> pending_list;
+  std::unique_ptr<StorageMigration<EdgeType>> migration;
+  // The engine replaced by the last migration. Neighbor views and ranges
+  // handed out before the switch may still point into it, so it is only
+  // released on the next write, which invalidates them anyway.
+  std::shared_ptr<PeakStorageInterface<VertexType, EdgeType>> retired_storage;
+  std::chrono::steady_clock::time_point migration_started;
+
+  std::shared_ptr<HybridCSR_COO<VertexType, EdgeType>> makeHybrid() const {
+    return std::make_shared<HybridCSR_COO<VertexType, EdgeType>>(
+        ctx->vertex_dictionary, ctx->thread_pool, ctx->stats);
+  }
+  StoreStats::Timer timeOp(StoreOp op) const {
+    return StoreStats::Timer(ctx->stats.get(), op);
+  }
+
+  void startMigration(StorageKind target) {
+    migration_started = std::chrono::steady_clock::now();
+    if (target == StorageKind::HybridCSR) {
+      pending_hybrid = makeHybrid();
+      migration = std::make_unique<StorageMigration<EdgeType>>(
+          ctx->adjacency_storage, pending_hybrid, target);
+    } else {
+      // The builder flushes the CSR before scanning it; reads of its
+      // published generations never wait for that.
+      pending_list = std::make_shared<AdjacencyList<VertexType, EdgeType>>(
+          ctx->vertex_dictionary);
+      migration = std::make_unique<StorageMigration<EdgeType>>(
+          ctx->hybrid_storage, pending_list, target);
+    }
+    LOG_DEBUG("Started background storage migration.");
+  }
+
+  void completeMigration() {
+    migration->finish();
+    retired_storage = ctx->active_storage;
+    if (migration->targetKind() == StorageKind::HybridCSR) {
+      ctx->hybrid_storage = std::move(pending_hybrid);
+      ctx->active_storage = ctx->hybrid_storage;
+      ctx->adjacency_storage =
+          std::make_shared<AdjacencyList<VertexType, EdgeType>>(
+              ctx->vertex_dictionary);
+      LOG_INFO("Switched active storage to HybridCSR_COO.");
+    } else {
+      ctx->adjacency_storage = std::move(pending_list);
+      ctx->active_storage = ctx->adjacency_storage;
+      ctx->hybrid_storage = makeHybrid();
+      LOG_INFO("Switched active storage to Adjacency Storage (list).");
+    }
+    if (ctx->stats)
+      ctx->stats->record(StoreOp::Migration,
+                         std::chrono::steady_clock::now() - migration_started);
+    active_kind = migration->targetKind();
+    migration.reset();
+  }
+
+  void adaptStorage() {
+    if (migration && migration->finished())
+      completeMigration();
+    if (!adaptive_eligible || !adaptive_policy.enabled ||
+        workload.operations() < adaptive_policy.window)
+      return;
+    if (!migration) {
+      if (active_kind == StorageKind::AdjacencyList &&
+          workload.readRatio() >= adaptive_policy.to_csr_read_ratio &&
+          ctx->metadata->num_edges >= adaptive_policy.min_edges &&
+          ctx->metadata->num_vertices >= adaptive_policy.min_vertices &&
+          ctx->metadata->density() >= adaptive_policy.min_density) {
+        startMigration(StorageKind::HybridCSR);
+      } else if (active_kind == StorageKind::HybridCSR &&
+                 workload.writeRatio() >=
+                     adaptive_policy.to_list_write_ratio) {
+        startMigration(StorageKind::AdjacencyList);
+      }
+    }
+    workload.reset();
+  }
+
+  void noteRead() const {
+    if constexpr (!is_static_storage) {
+      if (concurrent)
+        return;
+      workload.recordRead();
+    }
+  }
+  void noteWrites(size_t n = 1) {
+    if constexpr (!is_static_storage) {
+      if (concurrent)
+        return;
+      retired_storage.reset();
+      workload.recordWrites(n);
+      adaptStorage();
+    }
+  }
+  // While a migration is running, writes hold this lock and report what they
+  // changed so that the builder's copy stays complete.
+  std::unique_lock<std::shared_mutex> lockForMigration() {
+    if (!migration)
+      return {};
+    return migration->lockForWrite();
+  }
+  void journalVertex(const VertexType &v) {
+    if (migration)
+      migration->recordVertex(ctx->vertex_dictionary->find(v));
+  }
+  void journalEdge(const VertexType &src, const VertexType &dest,
+                   const EdgeType &weight,
+                   EdgeInsertMode mode = EdgeInsertMode::AllowParallel) {
+    if (migration)
+      migration->recordEdge(ctx->vertex_dictionary->find(src),
+                            ctx->vertex_dictionary->find(dest), weight, mode);
+  }
+
+  // Single storage probe shared by addEdge and upsertEdge.
+  std::pair<EdgeInsertResult, PeakStatus>
+  insertEdge(const VertexType &src, const VertexType &dest,
+             const EdgeType &weight, EdgeInsertMode mode) {
+    noteWrites();
+    auto migration_lock = lockForMigration();
+    auto [result, status] =
+        storage().impl_insertEdge(src, dest, weight, mode);
+    if (!status.isOK())
+      return {result, status};
+    switch (result) {
+    case EdgeInsertResult::Inserted:
+    case EdgeInsertResult::InsertedParallel:
+      journalEdge(src, dest, weight);
+      ctx->metadata->num_edges.add();
+      if (src == dest)
+        ctx->metadata->num_self_loops.add();
+      if (result == EdgeInsertResult::InsertedParallel)
+        ctx->metadata->num_parallel_edges.add();
+      break;
+    case EdgeInsertResult::Updated:
+      journalEdge(src, dest, weight, EdgeInsertMode::Upsert);
+      break;
+    case EdgeInsertResult::Existing:
+      LOG_DEBUG("Edge already exists");
+      break;
+    }
+    return {result, status};
+  }
+
+  // Accepts (src, dest) pairs/tuples as well as (src, dest, weight) tuples.
+  template <typename Edge>
+  static std::tuple<VertexType, VertexType, EdgeType>
+  toEdgeTuple(const Edge &edge) {
+    if constexpr (std::tuple_size_v<Edge> >= 3) {
+      return {std::get<0>(edge), std::get<1>(edge), std::get<2>(edge)};
+    } else {
+      return {std::get<0>(edge), std::get<1>(edge), EdgeType()};
+    }
+  }
+
+  // Applies the SelfLoops and ParallelEdges creation options to a whole
+  // batch at once instead of probing the storage per addEdge call.
+  void filterBatch(EdgeBatch &batch) {
+    if (!ctx->create_options->hasOption(GraphCreationOptions::SelfLoops)) {
+      batch.erase(std::remove_if(batch.begin(), batch.end(),
+                                 [](const auto &e) {
+                                   return std::get<0>(e) == std::get<1>(e);
+                                 }),
+                  batch.end());
+    }
+    if (ctx->create_options->hasOption(GraphCreationOptions::ParallelEdges))
+      return;
+    // Duplicates are found by sorting interned (src, dest) id pairs; edges
+    // with unknown endpoints are left for the engine to reject.
+    const auto &dictionary = *ctx->vertex_dictionary;
+    std::vector<std::tuple<VertexId, VertexId, size_t>> keys;
+    keys.reserve(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+      keys.emplace_back(dictionary.find(std::get<0>(batch[i])),
+                        dictionary.find(std::get<1>(batch[i])), i);
+    }
+    std::sort(keys.begin(), keys.end());
+    std::vector<bool> keep(batch.size(), true);
+    for (size_t k = 0; k < keys.size(); ++k) {
+      const auto &[src, dest, index] = keys[k];
+      if (src == INVALID_VERTEX_ID || dest == INVALID_VERTEX_ID)
+        continue;
+      if (k > 0 && std::get<0>(keys[k - 1]) == src &&
+          std::get<1>(keys[k - 1]) == dest) {
+        keep[index] = false;
+        continue;
+      }
+      keep[index] = !storage().impl_doesEdgeExist(
+          std::get<0>(batch[index]), std::get<1>(batch[index]));
+    }
+    size_t out = 0;
+    for (size_t i = 0; i < batch.size(); ++i) {
+      if (keep[i])
+        batch[out++] = std::move(batch[i]);
+    }
+    batch.erase(batch.begin() + out, batch.end());
+  }
+  // Updates the edge statistics for the first `added` edges of `batch`.
+  void countAddedEdges(const EdgeBatch &batch, size_t parallel_edges,
+                       size_t added) {
+    size_t self_loops = 0;
+    for (size_t i = 0; i < added; ++i)
+      self_loops += std::get<0>(batch[i]) == std::get<1>(batch[i]);
+    ctx->metadata->num_edges.add(added);
+    ctx->metadata->num_self_loops.add(self_loops);
+    ctx->metadata->num_parallel_edges.add(parallel_edges);
+  }
+  // filterBatch probes the whole batch before inserting it, which races with
+  // other writers; concurrent stores insert edge by edge under the shard
+  // locks instead, so a batch naming an unknown vertex is applied up to that
+  // edge.
+  PeakStatus addEdgesConcurrently(const EdgeBatch &batch) {
+    const bool self_loops =
+        ctx->create_options->hasOption(GraphCreationOptions::SelfLoops);
+    const EdgeInsertMode mode =
+        ctx->create_options->hasOption(GraphCreationOptions::ParallelEdges)
+            ? EdgeInsertMode::AllowParallel
+            : EdgeInsertMode::InsertIfAbsent;
+    for (const auto &[src, dest, weight] : batch) {
+      if (!self_loops && src == dest)
+        continue;
+      if (PeakStatus status = insertEdge(src, dest, weight, mode).second;
+          !status.isOK())
+        return status;
+    }
+    return PeakStatus::OK();
+  }
+  // Ingest for engines that cannot adopt a prebuilt CSR: every endpoint is
+  // added before any edge, partition by partition. Concurrent stores run
+  // the partitions on the thread pool.
+  PeakStatus commitIngestByBatches(IngestPipeline<VertexType, EdgeType> &in) {
+    std::mutex status_mutex;
+    PeakStatus result = PeakStatus::OK();
+    auto for_each_partition = [&](auto &&fn) {
+      auto run = [&](size_t lo, size_t hi) {
+        for (size_t p = lo; p < hi; ++p) {
+          if (PeakStatus status = fn(p); !status.isOK()) {
+            std::lock_guard<std::mutex> lock(status_mutex);
+            if (result.isOK())
+              result = status;
+          }
+        }
+      };
+      if (concurrent)
+        ctx->thread_pool->parallel_for(0, in.partitionCount(), run, 1);
+      else
+        run(0, in.partitionCount());
+    };
+    for_each_partition([&](size_t p) {
+      std::vector<VertexType> batch(in.verticesOf(p));
+      for (const auto &[src, dest, weight] : in.edgesOf(p)) {
+        batch.push_back(src);
+        batch.push_back(dest);
+      }
+      return addVertices(batch);
+    });
+    if (result.isOK())
+      for_each_partition([&](size_t p) { return addEdges(in.edgesOf(p)); });
+    in.clear();
+    return result;
+  }
   void initializeContext(const GraphInternalMetadata &metadata,
                          const GraphCreationOptions &options) {
     ctx->metadata = std::make_shared<GraphInternalMetadata>(metadata);
+    ctx->metadata->directed =
+        !options.hasOption(GraphCreationOptions::Undirected);
     ctx->create_options = std::make_shared<GraphCreationOptions>(options);
-    ctx->hybrid_storage =
-        std::make_shared<HybridCSR_COO<VertexType, EdgeType>>();
+    // Only the adjacency list is sharded for concurrent use.
+    constexpr bool list_engine =
+        !is_static_storage ||
+        std::is_same_v<Engine, AdjacencyList<VertexType, EdgeType>>;
+    if (options.hasOption(GraphCreationOptions::Concurrent)) {
+      if (list_engine && metadata.graph_type == "graph_list")
+        concurrent = true;
+      else
+        LOG_WARNING("Concurrent option requires an adjacency list; ignored.");
+    }
+    ctx->vertex_dictionary =
+        std::make_shared<VertexDictionary<VertexType>>(concurrent);
+    ctx->thread_pool =
+        options.threadCount()
+            ? std::make_shared<Concurrency::ThreadPool>(options.threadCount())
+            : Concurrency::ThreadPool::global();
+    if (options.hasOption(GraphCreationOptions::Instrumented))
+      ctx->stats = std::make_shared<StoreStats>();
+    if constexpr (is_static_storage) {
+      if constexpr (std::is_same_v<Engine,
+                                   AdjacencyMatrix<VertexType, EdgeType>>) {
+        static_engine.emplace(
+            ctx->vertex_dictionary,
+            !options.hasOption(GraphCreationOptions::Unweighted));
+        active_kind = StorageKind::Matrix;
+      } else if constexpr (std::is_same_v<
+                               Engine, HybridCSR_COO<VertexType, EdgeType>>) {
+        static_engine.emplace(ctx->vertex_dictionary, ctx->thread_pool,
+                              ctx->stats);
+        active_kind = StorageKind::HybridCSR;
+      } else {
+        static_engine.emplace(ctx->vertex_dictionary);
+        active_kind = StorageKind::AdjacencyList;
+      }
+      LOG_DEBUG("Bound storage engine at compile time.");
+      return;
+    }
+    ctx->hybrid_storage = makeHybrid();
     ctx->adjacency_storage =
-        std::make_shared<AdjacencyList<VertexType, EdgeType>>();
+        std::make_shared<AdjacencyList<VertexType, EdgeType>>(
+            ctx->vertex_dictionary);
     // ctx->coordinate_list =
     //     std::make_shared<CoordinateList<VertexType, EdgeType>>();
 
     if (ctx->metadata->graph_type == "graph_matrix") {
-      ctx->active_storage = ctx->adjacency_storage;
-      LOG_DEBUG("Set active storage to Adjacency Storage (matrix).");
+      ctx->matrix_storage =
+          std::make_shared<AdjacencyMatrix<VertexType, EdgeType>>(
+              ctx->vertex_dictionary,
+              !options.hasOption(GraphCreationOptions::Unweighted));
+      ctx->active_storage = ctx->matrix_storage;
+      active_kind = StorageKind::Matrix;
+      LOG_DEBUG("Set active storage to Matrix Storage.");
     } else if (ctx->metadata->graph_type == "graph_list") {
       ctx->active_storage = ctx->adjacency_storage;
+      adaptive_eligible = !concurrent;
       LOG_DEBUG("Set active storage to Adjacency Storage (list).");
     } else {
       LOG_WARNING(
@@ -46,43 +402,140 @@ public:
             const GraphCreationOptions &options =
                 CinderPeak::GraphCreationOptions::getDefaultCreateOptions())
       : ctx(std::make_shared<GraphContext<VertexType, EdgeType>>()) {
-    Logger::enableConsoleLogging = true;
     initializeContext(metadata, options);
     LOG_INFO("Successfully initialized context object.");
   }
 
   PeakStatus addEdge(const VertexType &src, const VertexType &dest,
                      const EdgeType &weight) {
-    if (ctx->active_storage->impl_doesEdgeExist(src, dest, weight)) {
-      LOG_DEBUG("Edge already exists");
-      if (!ctx->create_options->hasOption(GraphCreationOptions::ParallelEdges))
-        return PeakStatus::EdgeAlreadyExists();
-    }
     LOG_INFO("Called weighted PeakStore:addEdge");
-    if (auto status = ctx->active_storage->impl_addEdge(src, dest, weight);
-        !status.isOK()) {
-      return status;
-    }
-
-    ctx->metadata->num_edges++;
-    return PeakStatus::OK();
+    auto timer = timeOp(StoreOp::AddEdge);
+    const EdgeInsertMode mode =
+        ctx->create_options->hasOption(GraphCreationOptions::ParallelEdges)
+            ? EdgeInsertMode::AllowParallel
+            : EdgeInsertMode::InsertIfAbsent;
+    auto [result, status] = insertEdge(src, dest, weight, mode);
+    if (status.isOK() && result == EdgeInsertResult::Existing)
+      return PeakStatus::EdgeAlreadyExists();
+    return status;
   }
   PeakStatus addEdge(const VertexType &src, const VertexType &dest) {
-    if (ctx->active_storage->impl_doesEdgeExist(src, dest)) {
+    LOG_INFO("Called unweighted PeakStore:addEdge");
+    auto timer = timeOp(StoreOp::AddEdge);
+    auto [result, status] =
+        insertEdge(src, dest, EdgeType(), EdgeInsertMode::InsertIfAbsent);
+    if (status.isOK() && result == EdgeInsertResult::Existing)
       return PeakStatus::EdgeAlreadyExists();
+    return status;
+  }
+  // Inserts the edge, or overwrites the weight of the first existing
+  // (src, dest) edge.
+  std::pair<EdgeInsertResult, PeakStatus>
+  upsertEdge(const VertexType &src, const VertexType &dest,
+             const EdgeType &weight) {
+    LOG_INFO("Called PeakStore:upsertEdge");
+    auto timer = timeOp(StoreOp::AddEdge);
+    return insertEdge(src, dest, weight, EdgeInsertMode::Upsert);
+  }
+  template <typename Range> PeakStatus addVertices(const Range &vertices) {
+    auto timer = timeOp(StoreOp::AddVertices);
+    std::vector<VertexType> batch(std::begin(vertices), std::end(vertices));
+    noteWrites(batch.size());
+    auto migration_lock = lockForMigration();
+    auto [added, status] = storage().impl_addVertices(batch);
+    if (migration) {
+      for (const auto &v : batch)
+        journalVertex(v);
     }
-    LOG_INFO("Called unweighted PeakStore:addEdge");
-    if (auto status = ctx->active_storage->impl_addEdge(src, dest);
-        !status.isOK()) {
-      return status;
+    ctx->metadata->num_vertices.add(added);
+    return status;
+  }
+  template <typename Range> PeakStatus addEdges(const Range &edges) {
+    auto timer = timeOp(StoreOp::AddEdges);
+    EdgeBatch batch;
+    for (const auto &edge : edges)
+      batch.push_back(toEdgeTuple(edge));
+    if (concurrent)
+      return addEdgesConcurrently(batch);
+    noteWrites(batch.size());
+    auto migration_lock = lockForMigration();
+    filterBatch(batch);
+    // filterBatch leaves no repeats unless the store keeps parallel edges,
+    // in which case the engine counts them while inserting.
+    size_t parallel_edges = 0;
+    auto [added, status] = storage().impl_addEdges(
+        batch,
+        ctx->create_options->hasOption(GraphCreationOptions::ParallelEdges)
+            ? &parallel_edges
+            : nullptr);
+    if (migration && status.isOK()) {
+      for (const auto &[src, dest, weight] : batch)
+        journalEdge(src, dest, weight);
+    }
+    countAddedEdges(batch, parallel_edges, added);
+    return status;
+  }
+  // Starts a bulk load that any number of threads may push() into; see
+  // IngestPipeline.
+  IngestPipeline<VertexType, EdgeType> beginIngest() const {
+    return IngestPipeline<VertexType, EdgeType>(ctx->thread_pool->size() * 4);
+  }
+  // Merges everything pushed into `in` with the current graph and empties
+  // `in`. Must not run concurrently with other writes. Adjacency-list and
+  // CSR stores build the pushed edges into a CSR, merge it with the current
+  // rows in one pass per row and end up on HybridCSR_COO; other stores
+  // insert the edges through addVertices/addEdges.
+  PeakStatus commitIngest(IngestPipeline<VertexType, EdgeType> &in) {
+    LOG_INFO("Called PeakStore:commitIngest");
+    constexpr bool csr_engine =
+        !is_static_storage ||
+        std::is_same_v<Engine, HybridCSR_COO<VertexType, EdgeType>>;
+    if constexpr (!csr_engine) {
+      return commitIngestByBatches(in);
+    } else {
+      if (concurrent || active_kind == StorageKind::Matrix)
+        return commitIngestByBatches(in);
+      // Only the pushed edges are partitioned; the current graph joins them
+      // in the row-by-row merge, its edges ahead of the pushed ones.
+      const CsrSnapshot<EdgeType> base = csrSnapshot();
+      const bool parallel_edges =
+          ctx->create_options->hasOption(GraphCreationOptions::ParallelEdges);
+      auto csr = IngestPipeline<VertexType, EdgeType>::merge(
+          *ctx->thread_pool, base,
+          in.build(
+              *ctx->thread_pool, *ctx->vertex_dictionary,
+              ctx->create_options->hasOption(GraphCreationOptions::SelfLoops),
+              parallel_edges),
+          parallel_edges);
+      ctx->metadata->num_vertices.store(csr.vertices.size());
+      ctx->metadata->num_edges.add(csr.col_vals.size() - base.numEdges());
+      ctx->metadata->num_self_loops.add(csr.self_loops);
+      ctx->metadata->num_parallel_edges.add(csr.parallel_edges);
+      if constexpr (is_static_storage) {
+        static_engine->adopt(csr.vertices, std::move(csr.row_offsets),
+                             std::move(csr.col_vals), std::move(csr.weights));
+      } else {
+        auto hybrid = makeHybrid();
+        hybrid->adopt(csr.vertices, std::move(csr.row_offsets),
+                      std::move(csr.col_vals), std::move(csr.weights));
+        retired_storage = ctx->active_storage;
+        ctx->hybrid_storage = std::move(hybrid);
+        ctx->active_storage = ctx->hybrid_storage;
+        ctx->adjacency_storage =
+            std::make_shared<AdjacencyList<VertexType, EdgeType>>(
+                ctx->vertex_dictionary);
+        active_kind = StorageKind::HybridCSR;
+        workload.reset();
+      }
+      return PeakStatus::OK();
     }
-    ctx->metadata->num_edges++;
-    return PeakStatus::OK();
   }
   std::pair<EdgeType, PeakStatus> getEdge(const VertexType &src,
                                           const VertexType &dest) {
-    LOG_INFO("Called adjacency:getEdge()");
-    auto status = ctx->adjacency_storage->impl_getEdge(src, dest);
+    LOG_INFO("Called PeakStore:getEdge()");
+    auto timer = timeOp(StoreOp::GetEdge);
+    noteRead();
+    auto status = storage().impl_getEdge(src, dest);
     if (!status.second.isOK()) {
       return {EdgeType(), status.second};
     }
@@ -90,21 +543,133 @@ public:
   }
   PeakStatus addVertex(const VertexType &src) {
     LOG_INFO("Called peakStore:addVertex");
-    if (PeakStatus resp = ctx->active_storage->impl_addVertex(src);
+    auto timer = timeOp(StoreOp::AddVertex);
+    noteWrites();
+    auto migration_lock = lockForMigration();
+    if (PeakStatus resp = storage().impl_addVertex(src);
         !resp.isOK())
       return resp;
-    ctx->metadata->num_vertices++;
+    journalVertex(src);
+    ctx->metadata->num_vertices.add();
     return PeakStatus::OK();
   }
   const std::pair<std::vector<std::pair<VertexType, EdgeType>>, PeakStatus>
   getNeighbors(const VertexType &src) const {
-    LOG_INFO("Called adjacency:getNeighbors()");
-    auto status = ctx->adjacency_storage->impl_getNeighbors(src);
+    LOG_INFO("Called PeakStore:getNeighbors()");
+    auto timer = timeOp(StoreOp::GetNeighbors);
+    noteRead();
+    auto status = storage().impl_getNeighbors(src);
     if (!status.second.isOK()) {
       std::cout << status.second.message() << "\n";
     }
     return status;
   }
+  // Zero-copy counterpart of getNeighbors. The view reads engine storage in
+  // place and is invalidated by the next write.
+  std::pair<NeighborView<VertexType, EdgeType>, PeakStatus>
+  neighbors(const VertexType &src) {
+    auto timer = timeOp(StoreOp::GetNeighbors);
+    noteRead();
+    return storage().impl_neighbors(src);
+  }
+  VertexRange<VertexType, EdgeType, Engine> vertices() {
+    noteRead();
+    return {&storage(), ctx->vertex_dictionary.get()};
+  }
+  EdgeRange<VertexType, EdgeType, Engine> edges() {
+    noteRead();
+    return {&storage(), ctx->vertex_dictionary.get()};
+  }
+  // Out-edges as an immutable CSR indexed by VertexId, for the graph
+  // kernels in Algorithms/. CSR stores fold in pending edges and share
+  // their arrays; other engines are copied on the thread pool. Must not run
+  // concurrently with writes.
+  CsrSnapshot<EdgeType> csrSnapshot() {
+    waitForMigration();
+    if constexpr (is_static_storage) {
+      if constexpr (std::is_same_v<Engine,
+                                   HybridCSR_COO<VertexType, EdgeType>>)
+        return static_engine->snapshot();
+      else
+        return CsrSnapshot<EdgeType>::fromEngine(*static_engine,
+                                                 *ctx->thread_pool);
+    } else {
+      if (active_kind == StorageKind::HybridCSR)
+        return ctx->hybrid_storage->snapshot();
+      return CsrSnapshot<EdgeType>::fromEngine(*ctx->active_storage,
+                                               *ctx->thread_pool);
+    }
+  }
+  // Dense id of `v` in snapshots and algorithm results, or
+  // INVALID_VERTEX_ID.
+  VertexId vertexId(const VertexType &v) const {
+    return ctx->vertex_dictionary->find(v);
+  }
+  const VertexType &vertexAt(VertexId id) const {
+    return ctx->vertex_dictionary->vertex(id);
+  }
+  void setAdaptivePolicy(const AdaptiveStoragePolicy &policy) {
+    adaptive_policy = policy;
+    workload.reset();
+  }
+  const AdaptiveStoragePolicy &getAdaptivePolicy() const {
+    return adaptive_policy;
+  }
+  StorageKind activeStorageKind() const { return active_kind; }
+  // Counters, edge statistics and engine memory are always reported;
+  // latency histograms only for stores created with
+  // GraphCreationOptions::Instrumented. Engine sizes are read in place, so
+  // call this between writes.
+  StatsSnapshot stats() const {
+    StatsSnapshot out;
+    const auto &metadata = *ctx->metadata;
+    out.instrumented = ctx->stats != nullptr;
+    out.active_storage = storageKindName(active_kind);
+    out.num_vertices = metadata.num_vertices;
+    out.num_edges = metadata.num_edges;
+    out.num_self_loops = metadata.num_self_loops;
+    out.num_parallel_edges = metadata.num_parallel_edges;
+    out.density = metadata.density();
+    if (ctx->stats) {
+      for (size_t op = 0; op < static_cast<size_t>(StoreOp::Count); ++op) {
+        out.operations.push_back(
+            {storeOpName(static_cast<StoreOp>(op)),
+             ctx->stats->summary(static_cast<StoreOp>(op))});
+      }
+    }
+    std::shared_lock<std::shared_mutex> migration_lock;
+    if (migration)
+      migration_lock = migration->lockForRead();
+    auto report = [&out](const char *name, const auto *engine) {
+      if (engine)
+        out.engines.push_back({name, engine->impl_bytesAllocated()});
+    };
+    if constexpr (is_static_storage) {
+      report(storageKindName(active_kind), &*static_engine);
+    } else {
+      report("adjacency_list", ctx->adjacency_storage.get());
+      report("hybrid_csr", ctx->hybrid_storage.get());
+      report("matrix", ctx->matrix_storage.get());
+    }
+    return out;
+  }
+  // Installs a finished migration and starts a new one if the counted
+  // workload calls for it. Reads only count themselves, so a read-mostly
+  // store moves to the CSR here or on its next write. Like a write, this
+  // invalidates neighbor views and ranges.
+  void maintain() {
+    if constexpr (!is_static_storage) {
+      if (concurrent)
+        return;
+      retired_storage.reset();
+      adaptStorage();
+    }
+  }
+  // Blocks until an in-flight storage migration has been installed.
+  void waitForMigration() {
+    if (migration)
+      completeMigration();
+  }
   const std::shared_ptr<GraphContext<VertexType, EdgeType>> &
   getContext() const {
     return ctx;
@@ -0,0 +1,198 @@
+#pragma once
+#include "PeakLogger.hpp"
+#include "StorageEngine/VertexDictionary.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+namespace CinderPeak {
+namespace PeakStore {
+
+enum class StorageKind { AdjacencyList, HybridCSR, Matrix };
+
+inline const char *storageKindName(StorageKind kind) {
+  switch (kind) {
+  case StorageKind::AdjacencyList:
+    return "adjacency_list";
+  case StorageKind::HybridCSR:
+    return "hybrid_csr";
+  case StorageKind::Matrix:
+    return "matrix";
+  }
+  return "unknown";
+}
+
+template <typename T, typename = void> struct has_flush : std::false_type {};
+template <typename T>
+struct has_flush<T, std::void_t<decltype(std::declval<T &>().flush())>>
+    : std::true_type {};
+
+// Controls when a graph_list store moves between the adjacency list (cheap
+// writes) and the CSR engine (compact, cache-friendly reads).
+struct AdaptiveStoragePolicy {
+  bool enabled = true;
+  // Number of operations per evaluation window.
+  size_t window = 4096;
+  // Minimum fraction of reads in a window before moving to the CSR engine.
+  double to_csr_read_ratio = 0.9;
+  // Minimum fraction of writes in a window before moving back.
+  double to_list_write_ratio = 0.5;
+  // Graphs smaller than this are never migrated.
+  size_t min_edges = 4096;
+  size_t min_vertices = 64;
+  // Graphs sparser than this (see GraphInternalMetadata::density()) stay on
+  // the adjacency list; 0 lets any density move to the CSR engine.
+  double min_density = 0.0;
+};
+
+class WorkloadTracker {
+private:
+  size_t reads = 0;
+  size_t writes = 0;
+
+public:
+  void recordRead() { reads++; }
+  void recordWrites(size_t n = 1) { writes += n; }
+  size_t operations() const { return reads + writes; }
+  double readRatio() const {
+    return operations() ? static_cast<double>(reads) / operations() : 0.0;
+  }
+  double writeRatio() const {
+    return operations() ? static_cast<double>(writes) / operations() : 0.0;
+  }
+  void reset() { reads = writes = 0; }
+};
+
+// Copies one engine into another on a background thread while the source
+// keeps serving the graph. A source with pending edges is flushed first,
+// then rows are copied in chunks, each step under the lock: exclusively for
+// the flush, shared for a chunk. Foreground writes take the lock
+// exclusively, so a write waits for at most one step and reads never wait.
+// Writes that land in rows the builder has already copied are journaled and
+// replayed onto the target by finish(), which runs on the caller's thread
+// right before the engines are swapped.
+template <typename EdgeType> class StorageMigration {
+private:
+  struct JournalEntry {
+    VertexId src;
+    VertexId dest; // INVALID_VERTEX_ID for a vertex insertion
+    EdgeType weight;
+    EdgeInsertMode mode;
+  };
+
+  static constexpr size_t CHUNK_ROWS = 1024;
+
+  std::shared_mutex mutex;
+  std::atomic<size_t> copied_rows{0};
+  std::atomic<bool> done{false};
+  std::atomic<bool> cancelled{false};
+  std::vector<JournalEntry> journal;
+  std::function<void(const JournalEntry &)> replay;
+  std::thread builder;
+  StorageKind target_kind;
+
+  bool alreadyCopied(VertexId row) const {
+    return done.load(std::memory_order_relaxed) ||
+           row < copied_rows.load(std::memory_order_relaxed);
+  }
+
+public:
+  template <typename Source, typename Target>
+  StorageMigration(std::shared_ptr<Source> source,
+                   std::shared_ptr<Target> target, StorageKind kind)
+      : target_kind(kind) {
+    replay = [target](const JournalEntry &entry) {
+      if (entry.dest == INVALID_VERTEX_ID)
+        target->impl_addVertexById(entry.src);
+      else
+        target->impl_insertEdgeById(entry.src, entry.dest, entry.weight,
+                                    entry.mode);
+    };
+    builder = std::thread([this, source, target] {
+      if constexpr (has_flush<Source>::value) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        source->flush();
+      }
+      size_t next = 0;
+      while (!cancelled.load(std::memory_order_relaxed)) {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        const size_t rows = source->impl_rowCount();
+        const size_t end = std::min(rows, next + CHUNK_ROWS);
+        for (VertexId row = next; row < end; ++row) {
+          if (!source->impl_hasRow(row))
+            continue;
+          target->impl_addVertexById(row);
+        }
+        for (VertexId row = next; row < end; ++row) {
+          if (!source->impl_hasRow(row))
+            continue;
+          source->impl_forEachNeighbor(
+              row, [&](VertexId dest, const EdgeType &weight) {
+                target->impl_addVertexById(dest);
+                target->impl_addEdgeById(row, dest, weight);
+              });
+        }
+        next = end;
+        copied_rows.store(next, std::memory_order_relaxed);
+        if (next == rows) {
+          if constexpr (has_flush<Target>::value)
+            target->flush();
+          done.store(true, std::memory_order_release);
+          return;
+        }
+      }
+    });
+  }
+  StorageMigration(const StorageMigration &) = delete;
+  StorageMigration &operator=(const StorageMigration &) = delete;
+  ~StorageMigration() {
+    cancelled.store(true, std::memory_order_relaxed);
+    if (builder.joinable())
+      builder.join();
+  }
+
+  StorageKind targetKind() const { return target_kind; }
+  bool finished() const { return done.load(std::memory_order_acquire); }
+
+  // Held by the foreground for the duration of every write to the source.
+  std::unique_lock<std::shared_mutex> lockForWrite() {
+    return std::unique_lock<std::shared_mutex>(mutex);
+  }
+  // Held by the foreground while it reads writer-side state of the source,
+  // such as its allocation sizes, which the builder's flush may change.
+  std::shared_lock<std::shared_mutex> lockForRead() {
+    return std::shared_lock<std::shared_mutex>(mutex);
+  }
+  // Must be called with the write lock held, after the source was updated.
+  void recordVertex(VertexId id) {
+    if (alreadyCopied(id))
+      journal.push_back({id, INVALID_VERTEX_ID, EdgeType(),
+                         EdgeInsertMode::AllowParallel});
+  }
+  // `mode` is replayed as-is: AllowParallel for an insertion, Upsert for a
+  // weight update.
+  void recordEdge(VertexId src, VertexId dest, const EdgeType &weight,
+                  EdgeInsertMode mode = EdgeInsertMode::AllowParallel) {
+    if (alreadyCopied(src))
+      journal.push_back({src, dest, weight, mode});
+  }
+
+  // Waits for the builder and replays the journal onto the target.
+  void finish() {
+    if (builder.joinable())
+      builder.join();
+    for (const auto &entry : journal)
+      replay(entry);
+    journal.clear();
+    LOG_DEBUG("Storage migration finished.");
+  }
+};
+
+} // namespace PeakStore
+} // namespace CinderPeak
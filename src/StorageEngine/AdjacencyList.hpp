@@ -1,44 +1,134 @@
 #pragma once
 #include "StorageEngine/GraphContext.hpp"
+#include "StorageEngine/NeighborList.hpp"
+#include "StorageEngine/NeighborView.hpp"
+#include "StorageEngine/VertexDictionary.hpp"
 #include "Utils.hpp"
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 namespace CinderPeak {
 template <typename, typename> class PeakStorageInterface;
 
 namespace PeakStore {
 template <typename VertexType, typename EdgeType>
-class AdjacencyList
+class AdjacencyList final
     : public CinderPeak::PeakStorageInterface<VertexType, EdgeType> {
 private:
-  std::unordered_map<VertexType, std::vector<std::pair<VertexType, EdgeType>>,
-                     VertexHasher<VertexType>>
-      _adj_list;
+  // Rows are partitioned into shards by the low bits of their id, matching
+  // the dictionary's shards. In concurrent mode each shard is guarded by its
+  // own reader-writer lock, so operations on vertices in different shards
+  // never contend. A single-threaded list has one shard and takes no locks.
+  struct Shard {
+    mutable std::shared_mutex mutex;
+    // Indexed by id >> _shard_bits; neighbors are stored as ids, not vertex
+    // copies.
+    std::vector<NeighborList<EdgeType>> rows;
+    std::vector<bool> present;
+  };
+
+  std::shared_ptr<VertexDictionary<VertexType>> _vertices;
+  size_t _shard_bits;
+  bool _concurrent;
+  std::unique_ptr<Shard[]> _shards;
+  // One past the largest row id added so far.
+  std::atomic<size_t> _row_count{0};
+
+  Shard &shardOf(VertexId id) const {
+    return _shards[id & ((size_t{1} << _shard_bits) - 1)];
+  }
+  size_t slotOf(VertexId id) const { return id >> _shard_bits; }
+  NeighborList<EdgeType> &rowAt(VertexId id) const {
+    return shardOf(id).rows[slotOf(id)];
+  }
+  std::shared_lock<std::shared_mutex> readLock(VertexId id) const {
+    if (!_concurrent)
+      return {};
+    return std::shared_lock<std::shared_mutex>(shardOf(id).mutex);
+  }
+  std::unique_lock<std::shared_mutex> writeLock(VertexId id) const {
+    if (!_concurrent)
+      return {};
+    return std::unique_lock<std::shared_mutex>(shardOf(id).mutex);
+  }
+  // Callers hold the shard lock of `id`.
+  bool presentLocked(VertexId id) const {
+    const Shard &shard = shardOf(id);
+    const size_t slot = slotOf(id);
+    return slot < shard.present.size() && shard.present[slot];
+  }
+  bool isPresent(VertexId id) const {
+    if (id == INVALID_VERTEX_ID)
+      return false;
+    auto lock = readLock(id);
+    return presentLocked(id);
+  }
+
+  // Returns the id of `v` if it has been added to this list.
+  VertexId rowOf(const VertexType &v) const {
+    VertexId id = _vertices->find(v);
+    return isPresent(id) ? id : INVALID_VERTEX_ID;
+  }
+  bool insertVertex(VertexId id) {
+    {
+      auto lock = writeLock(id);
+      Shard &shard = shardOf(id);
+      const size_t slot = slotOf(id);
+      if (slot >= shard.present.size()) {
+        shard.present.resize(slot + 1, false);
+        shard.rows.resize(slot + 1);
+      }
+      if (shard.present[slot])
+        return false;
+      shard.present[slot] = true;
+    }
+    size_t rows = _row_count.load(std::memory_order_relaxed);
+    while (rows <= id && !_row_count.compare_exchange_weak(
+                             rows, size_t{id} + 1, std::memory_order_relaxed))
+      ;
+    return true;
+  }
 
 public:
+  using typename CinderPeak::PeakStorageInterface<VertexType,
+                                                  EdgeType>::EdgeBatch;
+
   // TODO: combine two impl_addEdge overloads into one.
-  AdjacencyList() { LOG_INFO("Initialized Adjacency List object"); }
+  // The list is concurrent when its dictionary is.
+  AdjacencyList(
+      std::shared_ptr<VertexDictionary<VertexType>> dictionary = nullptr)
+      : _vertices(dictionary
+                      ? std::move(dictionary)
+                      : std::make_shared<VertexDictionary<VertexType>>()),
+        _shard_bits(_vertices->shardBits()),
+        _concurrent(_vertices->isConcurrent()),
+        _shards(std::make_unique<Shard[]>(size_t{1} << _shard_bits)) {
+    LOG_INFO("Initialized Adjacency List object");
+  }
   const PeakStatus impl_addEdge(const VertexType &src, const VertexType &dest,
                                 const EdgeType &weight) {
-    if (auto it = _adj_list.find(src); it == _adj_list.end())
-      return PeakStatus::VertexNotFound();
-    if (auto it = _adj_list.find(dest); it == _adj_list.end())
-      return PeakStatus::VertexNotFound();
-    _adj_list[src].emplace_back(dest, weight);
-    return PeakStatus::OK();
+    return impl_insertEdge(src, dest, weight, EdgeInsertMode::AllowParallel)
+        .second;
   }
   const PeakStatus impl_addEdge(const VertexType &src,
                                 const VertexType &dest) override {
-    if (auto it = _adj_list.find(src); it == _adj_list.end())
-      return PeakStatus::VertexNotFound();
-    if (auto it = _adj_list.find(dest); it == _adj_list.end())
-      return PeakStatus::VertexNotFound();
-    _adj_list[src].emplace_back(dest, EdgeType());
-    return PeakStatus::OK();
+    return impl_addEdge(src, dest, EdgeType());
+  }
+  const std::pair<EdgeInsertResult, PeakStatus>
+  impl_insertEdge(const VertexType &src, const VertexType &dest,
+                  const EdgeType &weight, EdgeInsertMode mode) override {
+    VertexId src_id = rowOf(src);
+    VertexId dest_id = rowOf(dest);
+    if (src_id == INVALID_VERTEX_ID || dest_id == INVALID_VERTEX_ID)
+      return {EdgeInsertResult::Existing, PeakStatus::VertexNotFound()};
+    return {impl_insertEdgeById(src_id, dest_id, weight, mode),
+            PeakStatus::OK()};
   }
   const PeakStatus impl_addVertex(const VertexType &src) override {
+    VertexId id = _vertices->intern(src).first;
     if constexpr (is_primitive_or_string_v<VertexType>) {
-      auto it = _adj_list.find(src);
-      if (it != _adj_list.end()) {
+      if (!insertVertex(id)) {
         LOG_WARNING("Vertex already exists with primitive type");
         return PeakStatus::VertexAlreadyExists(
             "Primitive Vertex Already Exists");
@@ -46,83 +136,203 @@ public:
       LOG_DEBUG("Unmatched vertices");
       LOG_INFO("Inside primitive block");
     } else {
-      auto it = _adj_list.find(src);
-      if (it != _adj_list.end()) {
-        const VertexType &existingVertex = it->first;
-        if (existingVertex.__id_ == src.__id_) {
-          LOG_DEBUG("Matching vertex IDs");
-          return PeakStatus::VertexAlreadyExists(
-              "Non Primitive Vertex Already Exists");
-        }
+      if (!insertVertex(id)) {
+        LOG_DEBUG("Matching vertex IDs");
+        return PeakStatus::VertexAlreadyExists(
+            "Non Primitive Vertex Already Exists");
       }
       LOG_INFO("Inside non primitive block");
     }
-    _adj_list[src] = std::vector<std::pair<VertexType, EdgeType>>();
     return PeakStatus::OK();
   }
-  bool impl_doesEdgeExist(const VertexType &src,
-                          const VertexType &dest) override {
-    auto it = _adj_list.find(src);
-    if (it == _adj_list.end()) { // Vertex 'src' not found
-      return false;
+  const std::pair<size_t, PeakStatus>
+  impl_addVertices(const std::vector<VertexType> &vertices) override {
+    _vertices->reserve(_vertices->size() + vertices.size());
+    size_t added = 0;
+    for (const auto &v : vertices) {
+      if (insertVertex(_vertices->intern(v).first))
+        added++;
     }
-
-    const auto &neighbors = it->second;
-    for (const auto &[neighbor, edge] : neighbors) {
-      if (neighbor == dest) { // Edge exists
-        return true;
+    return {added, PeakStatus::OK()};
+  }
+  const std::pair<size_t, PeakStatus>
+  impl_addEdges(const EdgeBatch &edges, size_t *parallel = nullptr) override {
+    // Resolve every endpoint up front so that a batch referencing an
+    // unknown vertex is rejected without being partially applied.
+    std::vector<std::pair<VertexId, VertexId>> ids;
+    ids.reserve(edges.size());
+    for (const auto &[src, dest, weight] : edges) {
+      VertexId src_id = rowOf(src);
+      VertexId dest_id = rowOf(dest);
+      if (src_id == INVALID_VERTEX_ID || dest_id == INVALID_VERTEX_ID)
+        return {0, PeakStatus::VertexNotFound()};
+      ids.emplace_back(src_id, dest_id);
+    }
+    for (size_t i = 0; i < edges.size(); ++i) {
+      if (!parallel) {
+        impl_addEdgeById(ids[i].first, ids[i].second, std::get<2>(edges[i]));
+        continue;
       }
+      *parallel += impl_insertEdgeById(ids[i].first, ids[i].second,
+                                       std::get<2>(edges[i]),
+                                       EdgeInsertMode::AllowParallel) ==
+                   EdgeInsertResult::InsertedParallel;
     }
-    return false;
+    return {edges.size(), PeakStatus::OK()};
+  }
+  bool impl_doesEdgeExist(const VertexType &src,
+                          const VertexType &dest) override {
+    VertexId src_id = _vertices->find(src);
+    VertexId dest_id = _vertices->find(dest);
+    if (src_id == INVALID_VERTEX_ID) // Vertex 'src' not found
+      return false;
+    auto lock = readLock(src_id);
+    return presentLocked(src_id) &&
+           rowAt(src_id).find(dest_id) != NeighborList<EdgeType>::npos;
   }
 
   const std::pair<EdgeType, PeakStatus>
   impl_getEdge(const VertexType &src, const VertexType &dest) override {
-    auto it = _adj_list.find(src);
-    if (it == _adj_list.end()) {
+    VertexId src_id = _vertices->find(src);
+    VertexId dest_id = _vertices->find(dest);
+    if (src_id == INVALID_VERTEX_ID) {
       return std::make_pair(EdgeType(), PeakStatus::VertexNotFound());
     }
-    for (const auto &[neighbor, edge] : it->second) {
-      if (neighbor == dest) {
-        return std::make_pair(edge, PeakStatus::OK());
-      }
+    auto lock = readLock(src_id);
+    if (!presentLocked(src_id)) {
+      return std::make_pair(EdgeType(), PeakStatus::VertexNotFound());
+    }
+    const auto &neighbors = rowAt(src_id);
+    size_t pos = neighbors.find(dest_id);
+    if (pos != NeighborList<EdgeType>::npos) {
+      return std::make_pair(neighbors.weightAt(pos), PeakStatus::OK());
     }
     return std::make_pair(EdgeType(), PeakStatus::EdgeNotFound());
   }
   const std::pair<std::vector<std::pair<VertexType, EdgeType>>, PeakStatus>
-  impl_getNeighbors(const VertexType &vertex) const {
-    auto it = _adj_list.find(vertex);
-    if (it == _adj_list.end()) {
+  impl_getNeighbors(const VertexType &vertex) const override {
+    VertexId id = _vertices->find(vertex);
+    auto lock = id == INVALID_VERTEX_ID
+                    ? std::shared_lock<std::shared_mutex>()
+                    : readLock(id);
+    if (id == INVALID_VERTEX_ID || !presentLocked(id)) {
       static const std::vector<std::pair<VertexType, EdgeType>> empty_vec;
       return std::make_pair(empty_vec, PeakStatus::VertexNotFound());
     }
-    return std::make_pair(it->second, CinderPeak::PeakStatus::OK());
+    std::vector<std::pair<VertexType, EdgeType>> neighbors;
+    neighbors.reserve(rowAt(id).size());
+    impl_forEachNeighbor(id, [&](VertexId neighbor, const EdgeType &edge) {
+      neighbors.emplace_back(_vertices->vertex(neighbor), edge);
+    });
+    return std::make_pair(std::move(neighbors), CinderPeak::PeakStatus::OK());
+  }
+  // Materializes the id-based rows back into a vertex-keyed map.
+  auto getAdjList() const {
+    std::unordered_map<VertexType, std::vector<std::pair<VertexType, EdgeType>>,
+                       VertexHasher<VertexType>>
+        adj_list;
+    const size_t rows = impl_rowCount();
+    adj_list.reserve(rows);
+    for (VertexId id = 0; id < rows; ++id) {
+      auto lock = readLock(id);
+      if (!presentLocked(id))
+        continue;
+      auto &neighbors = adj_list[_vertices->vertex(id)];
+      neighbors.reserve(rowAt(id).size());
+      impl_forEachNeighbor(id, [&](VertexId neighbor, const EdgeType &edge) {
+        neighbors.emplace_back(_vertices->vertex(neighbor), edge);
+      });
+    }
+    return adj_list;
   }
-  auto getAdjList() { return _adj_list; }
   bool impl_doesEdgeExist(const VertexType &src, const VertexType &dest,
                           const EdgeType &weight) override {
-    auto it = _adj_list.find(src);
-    if (it == _adj_list.end()) {
+    if (!impl_doesEdgeExist(src, dest)) {
       return false;
     }
-    const auto &neighbors = it->second;
-    for (const auto &[neighbor, edge] : neighbors) {
-      if (neighbor == dest) {
-        if (isTypePrimitive<EdgeType>()) {
-          LOG_CRITICAL("ID EQUAL");
-        }
-        return true;
+    if (isTypePrimitive<EdgeType>()) {
+      LOG_CRITICAL("ID EQUAL");
+    }
+    return true;
+  }
+  std::pair<NeighborView<VertexType, EdgeType>, PeakStatus>
+  impl_neighbors(const VertexType &vertex) override {
+    VertexId id = rowOf(vertex);
+    if (id == INVALID_VERTEX_ID)
+      return {{}, PeakStatus::VertexNotFound()};
+    return {impl_neighborsById(id), PeakStatus::OK()};
+  }
+
+  // Id-level access used by storage migration and graph iteration; callers
+  // pass ids obtained from the shared dictionary. Views and
+  // impl_forEachNeighbor read rows without taking the shard lock, so in
+  // concurrent mode they must not overlap writes to the same row.
+  size_t impl_rowCount() const override {
+    return _row_count.load(std::memory_order_relaxed);
+  }
+  size_t impl_bytesAllocated() const override {
+    size_t bytes = 0;
+    for (size_t s = 0; s < (size_t{1} << _shard_bits); ++s) {
+      const Shard &shard = _shards[s];
+      std::shared_lock<std::shared_mutex> lock(shard.mutex, std::defer_lock);
+      if (_concurrent)
+        lock.lock();
+      bytes += shard.rows.capacity() * sizeof(NeighborList<EdgeType>) +
+               shard.present.capacity() / 8;
+      for (const auto &row : shard.rows)
+        bytes += row.bytesAllocated();
+    }
+    return bytes;
+  }
+  bool impl_hasRow(VertexId id) const override { return isPresent(id); }
+  NeighborView<VertexType, EdgeType>
+  impl_neighborsById(VertexId row) override {
+    const auto &neighbors = rowAt(row);
+    return {_vertices.get(),
+            NeighborRun<EdgeType>::contiguous(neighbors.idData(),
+                                              neighbors.weightData(),
+                                              neighbors.size())};
+  }
+  template <typename Fn>
+  void impl_forEachNeighbor(VertexId row, Fn &&fn) const {
+    const auto &neighbors = rowAt(row);
+    for (size_t pos = 0; pos < neighbors.size(); ++pos)
+      fn(neighbors.idAt(pos), neighbors.weightAt(pos));
+  }
+  bool impl_addVertexById(VertexId id) { return insertVertex(id); }
+  void impl_addEdgeById(VertexId src, VertexId dest, const EdgeType &weight) {
+    auto lock = writeLock(src);
+    rowAt(src).push_back(dest, weight);
+  }
+  EdgeInsertResult impl_insertEdgeById(VertexId src, VertexId dest,
+                                       const EdgeType &weight,
+                                       EdgeInsertMode mode) {
+    auto lock = writeLock(src);
+    auto &neighbors = rowAt(src);
+    size_t pos = neighbors.find(dest);
+    if (pos != NeighborList<EdgeType>::npos) {
+      if (mode == EdgeInsertMode::AllowParallel) {
+        neighbors.push_back(dest, weight);
+        return EdgeInsertResult::InsertedParallel;
       }
+      if (mode == EdgeInsertMode::InsertIfAbsent)
+        return EdgeInsertResult::Existing;
+      neighbors.weightAt(pos) = weight;
+      return EdgeInsertResult::Updated;
     }
-    return false;
+    neighbors.push_back(dest, weight);
+    return EdgeInsertResult::Inserted;
   }
   void print_adj_list() {
-    for (const auto &[first, second] : _adj_list) {
-      std::cout << "Vertex: " << first << "'s adj list:\n";
-      for (const auto &pr : second) {
-        std::cout << "  Neighbor: " << pr.first << " Weight: " << pr.second
-                  << "\n";
-      }
+    for (VertexId id = 0; id < impl_rowCount(); ++id) {
+      auto lock = readLock(id);
+      if (!presentLocked(id))
+        continue;
+      std::cout << "Vertex: " << _vertices->vertex(id) << "'s adj list:\n";
+      impl_forEachNeighbor(id, [&](VertexId neighbor, const EdgeType &edge) {
+        std::cout << "  Neighbor: " << _vertices->vertex(neighbor)
+                  << " Weight: " << edge << "\n";
+      });
     }
   }
 };
@@ -0,0 +1,192 @@
+#pragma once
+#include "../StorageInterface.hpp"
+#include "StorageEngine/GraphContext.hpp"
+#include "StorageEngine/MatrixBlock.hpp"
+#include "StorageEngine/NeighborView.hpp"
+#include "StorageEngine/VertexDictionary.hpp"
+#include "Utils.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+namespace CinderPeak {
+template <typename, typename> class PeakStorageInterface;
+namespace PeakStore {
+
+// Dense matrix engine. The matrix is tiled into BLOCK_DIM x BLOCK_DIM
+// MatrixBlocks addressed by (src_id / BLOCK_DIM, dest_id / BLOCK_DIM). Blocks
+// are allocated on the first edge that lands in them, so growing the vertex
+// set never moves existing blocks.
+template <typename VertexType, typename EdgeType>
+class AdjacencyMatrix final
+    : public PeakStorageInterface<VertexType, EdgeType> {
+public:
+  static constexpr size_t BLOCK_DIM = MATRIX_BLOCK_DIM;
+
+private:
+  using Block = MatrixBlock<EdgeType>;
+
+  std::shared_ptr<VertexDictionary<VertexType>> vertices;
+  std::vector<bool> vertex_present;
+  // blocks[block_row][block_col]; null until an edge is stored in it.
+  std::vector<std::vector<std::unique_ptr<Block>>> blocks;
+  bool weighted;
+
+  VertexId rowOf(const VertexType &v) const {
+    VertexId id = vertices->find(v);
+    if (id == INVALID_VERTEX_ID || id >= vertex_present.size() ||
+        !vertex_present[id])
+      return INVALID_VERTEX_ID;
+    return id;
+  }
+
+  bool insertVertex(VertexId id) {
+    if (id >= vertex_present.size()) {
+      vertex_present.resize(id + 1, false);
+      const size_t block_count = id / BLOCK_DIM + 1;
+      if (block_count > blocks.size()) {
+        blocks.resize(block_count);
+        for (auto &block_row : blocks)
+          block_row.resize(block_count);
+      }
+    }
+    if (vertex_present[id])
+      return false;
+    vertex_present[id] = true;
+    return true;
+  }
+
+  const Block *blockAt(VertexId src, VertexId dest) const {
+    return blocks[src / BLOCK_DIM][dest / BLOCK_DIM].get();
+  }
+
+public:
+  explicit AdjacencyMatrix(
+      std::shared_ptr<VertexDictionary<VertexType>> dictionary = nullptr,
+      bool weighted = true)
+      : vertices(dictionary
+                     ? std::move(dictionary)
+                     : std::make_shared<VertexDictionary<VertexType>>()),
+        weighted(weighted) {
+    LOG_INFO("Initialized Adjacency Matrix object");
+  }
+
+  const PeakStatus impl_addVertex(const VertexType &src) override {
+    if (!insertVertex(vertices->intern(src).first))
+      return PeakStatus::VertexAlreadyExists();
+    return PeakStatus::OK();
+  }
+
+  // A matrix holds at most one edge per (src, dest); AllowParallel behaves
+  // like Upsert.
+  EdgeInsertResult impl_insertEdgeById(VertexId src, VertexId dest,
+                                       const EdgeType &weight,
+                                       EdgeInsertMode mode) {
+    auto &block = blocks[src / BLOCK_DIM][dest / BLOCK_DIM];
+    if (!block)
+      block = std::make_unique<Block>(weighted);
+    const size_t r = src % BLOCK_DIM, c = dest % BLOCK_DIM;
+    if (mode == EdgeInsertMode::InsertIfAbsent && block->test(r, c))
+      return EdgeInsertResult::Existing;
+    return block->set(r, c, weight) ? EdgeInsertResult::Updated
+                                    : EdgeInsertResult::Inserted;
+  }
+
+  const std::pair<EdgeInsertResult, PeakStatus>
+  impl_insertEdge(const VertexType &src, const VertexType &dest,
+                  const EdgeType &weight, EdgeInsertMode mode) override {
+    VertexId src_id = rowOf(src);
+    VertexId dest_id = rowOf(dest);
+    if (src_id == INVALID_VERTEX_ID || dest_id == INVALID_VERTEX_ID)
+      return {EdgeInsertResult::Existing, PeakStatus::VertexNotFound()};
+    return {impl_insertEdgeById(src_id, dest_id, weight, mode),
+            PeakStatus::OK()};
+  }
+
+  // Adding an existing edge overwrites its weight.
+  const PeakStatus impl_addEdge(const VertexType &src, const VertexType &dest,
+                                const EdgeType &weight) override {
+    return impl_insertEdge(src, dest, weight, EdgeInsertMode::Upsert).second;
+  }
+  const PeakStatus impl_addEdge(const VertexType &src,
+                                const VertexType &dest) override {
+    return impl_addEdge(src, dest, EdgeType());
+  }
+
+  bool impl_doesEdgeExist(const VertexType &src,
+                          const VertexType &dest) override {
+    return impl_getEdge(src, dest).second.isOK();
+  }
+  bool impl_doesEdgeExist(const VertexType &src, const VertexType &dest,
+                          const EdgeType &weight) override {
+    auto edge = impl_getEdge(src, dest);
+    return edge.second.isOK() && edge.first == weight;
+  }
+
+  const std::pair<EdgeType, PeakStatus>
+  impl_getEdge(const VertexType &src, const VertexType &dest) override {
+    VertexId src_id = rowOf(src);
+    VertexId dest_id = rowOf(dest);
+    if (src_id == INVALID_VERTEX_ID || dest_id == INVALID_VERTEX_ID)
+      return {EdgeType(), PeakStatus::VertexNotFound()};
+    const Block *block = blockAt(src_id, dest_id);
+    const size_t r = src_id % BLOCK_DIM, c = dest_id % BLOCK_DIM;
+    if (!block || !block->test(r, c))
+      return {EdgeType(), PeakStatus::EdgeNotFound()};
+    const EdgeType *weight = block->weight(r, c);
+    return {weight ? *weight : EdgeType(), PeakStatus::OK()};
+  }
+
+  const std::pair<std::vector<std::pair<VertexType, EdgeType>>, PeakStatus>
+  impl_getNeighbors(const VertexType &vertex) const override {
+    VertexId id = rowOf(vertex);
+    if (id == INVALID_VERTEX_ID)
+      return {{}, PeakStatus::VertexNotFound()};
+    std::vector<std::pair<VertexType, EdgeType>> neighbors;
+    const size_t r = id % BLOCK_DIM;
+    const auto &block_row = blocks[id / BLOCK_DIM];
+    for (size_t bc = 0; bc < block_row.size(); ++bc) {
+      const Block *block = block_row[bc].get();
+      if (!block)
+        continue;
+      for (std::uint64_t word = block->bits[r]; word; word &= word - 1) {
+        const size_t c = countTrailingZeros(word);
+        const EdgeType *weight = block->weight(r, c);
+        neighbors.emplace_back(vertices->vertex(bc * BLOCK_DIM + c),
+                               weight ? *weight : EdgeType());
+      }
+    }
+    return {std::move(neighbors), PeakStatus::OK()};
+  }
+
+  std::pair<NeighborView<VertexType, EdgeType>, PeakStatus>
+  impl_neighbors(const VertexType &vertex) override {
+    VertexId id = rowOf(vertex);
+    if (id == INVALID_VERTEX_ID)
+      return {{}, PeakStatus::VertexNotFound()};
+    return {impl_neighborsById(id), PeakStatus::OK()};
+  }
+
+  size_t impl_rowCount() const override { return vertex_present.size(); }
+  size_t impl_bytesAllocated() const override {
+    size_t bytes = vertex_present.capacity() / 8;
+    for (const auto &block_row : blocks) {
+      bytes += block_row.capacity() * sizeof(std::unique_ptr<Block>);
+      for (const auto &block : block_row)
+        bytes += block ? block->bytesAllocated() : 0;
+    }
+    return bytes;
+  }
+  bool impl_hasRow(VertexId id) const override {
+    return id < vertex_present.size() && vertex_present[id];
+  }
+  // The view walks the row's bits across its row of blocks in place.
+  NeighborView<VertexType, EdgeType>
+  impl_neighborsById(VertexId row) override {
+    const auto &block_row = blocks[row / BLOCK_DIM];
+    return {vertices.get(), block_row.data(), block_row.size(),
+            row % BLOCK_DIM};
+  }
+};
+
+} // namespace PeakStore
+} // namespace CinderPeak
@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+namespace CinderPeak {
+namespace PeakStore {
+
+// A grow-only bitset that can be read while it is being written. Bits live in
+// segments that double in size and are never moved once allocated, so
+// test() needs no lock: segment k holds FIRST_BITS << k bits starting at bit
+// FIRST_BITS * (2^k - 1).
+class ConcurrentBitset {
+public:
+  ConcurrentBitset() = default;
+  ConcurrentBitset(const ConcurrentBitset &) = delete;
+  ConcurrentBitset &operator=(const ConcurrentBitset &) = delete;
+  ~ConcurrentBitset() {
+    for (auto &segment : segments)
+      delete[] segment.load(std::memory_order_relaxed);
+  }
+
+  bool test(size_t bit) const {
+    const auto [k, offset] = locate(bit);
+    const Word *segment = segments[k].load(std::memory_order_acquire);
+    if (!segment)
+      return false;
+    return (segment[offset / WORD_BITS].load(std::memory_order_acquire) >>
+            (offset % WORD_BITS)) &
+           1;
+  }
+  // Returns true if the bit was clear.
+  bool set(size_t bit) {
+    const auto [k, offset] = locate(bit);
+    Word *segment = segments[k].load(std::memory_order_acquire);
+    if (!segment) {
+      Word *fresh = new Word[(FIRST_BITS << k) / WORD_BITS]();
+      if (segments[k].compare_exchange_strong(segment, fresh,
+                                              std::memory_order_acq_rel))
+        segment = fresh;
+      else
+        delete[] fresh;
+    }
+    const std::uint64_t mask = std::uint64_t{1} << (offset % WORD_BITS);
+    return !(segment[offset / WORD_BITS].fetch_or(
+                 mask, std::memory_order_acq_rel) &
+             mask);
+  }
+  // Clears every bit; not atomic with respect to concurrent readers.
+  void reset() {
+    for (size_t k = 0; k < SEGMENTS; ++k) {
+      Word *segment = segments[k].load(std::memory_order_relaxed);
+      if (!segment)
+        continue;
+      for (size_t w = 0; w < (FIRST_BITS << k) / WORD_BITS; ++w)
+        segment[w].store(0, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  using Word = std::atomic<std::uint64_t>;
+  static constexpr size_t WORD_BITS = 64;
+  static constexpr size_t FIRST_BITS = 1024;
+  static constexpr size_t SEGMENTS = 48;
+
+  std::atomic<Word *> segments[SEGMENTS] = {};
+
+  static std::pair<size_t, size_t> locate(size_t bit) {
+    const std::uint64_t q = bit / FIRST_BITS + 1;
+    size_t k = 0;
+#if defined(__GNUC__) || defined(__clang__)
+    k = 63 - static_cast<size_t>(__builtin_clzll(q));
+#else
+    while (q >> (k + 1))
+      ++k;
+#endif
+    return {k, bit - FIRST_BITS * ((size_t{1} << k) - 1)};
+  }
+};
+
+} // namespace PeakStore
+} // namespace CinderPeak
@@ -0,0 +1,183 @@
+#pragma once
+#include "Concurrency/ThreadPool.hpp"
+#include "StorageEngine/VertexDictionary.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+namespace CinderPeak {
+namespace PeakStore {
+
+// Immutable compressed-sparse-row copy of a graph's edges for the kernels in
+// Algorithms/. Row v spans [row_offsets[v], row_offsets[v + 1]) of col_vals
+// and weights and is sorted by destination; rows run over every VertexId
+// below numVertices(), and ids the engine does not hold are empty rows that
+// `present` marks as such. The arrays are shared, so copies are cheap and a
+// snapshot taken from HybridCSR_COO stays valid after later writes to the
+// graph.
+template <typename EdgeType> struct CsrSnapshot {
+  std::shared_ptr<const std::vector<size_t>> row_offsets =
+      std::make_shared<const std::vector<size_t>>(1, 0);
+  std::shared_ptr<const std::vector<VertexId>> col_vals =
+      std::make_shared<const std::vector<VertexId>>();
+  // Parallel to col_vals, or empty when the snapshot carries no weights.
+  std::shared_ptr<const std::vector<EdgeType>> weights =
+      std::make_shared<const std::vector<EdgeType>>();
+  // present[v] is nonzero when v is a vertex, or empty when every id below
+  // numVertices() is one, as with a non-concurrent dictionary.
+  std::shared_ptr<const std::vector<std::uint8_t>> present =
+      std::make_shared<const std::vector<std::uint8_t>>();
+
+  CsrSnapshot() = default;
+  CsrSnapshot(std::vector<size_t> offsets, std::vector<VertexId> cols,
+              std::vector<EdgeType> edge_weights = {})
+      : row_offsets(std::make_shared<const std::vector<size_t>>(
+            std::move(offsets))),
+        col_vals(std::make_shared<const std::vector<VertexId>>(
+            std::move(cols))),
+        weights(std::make_shared<const std::vector<EdgeType>>(
+            std::move(edge_weights))) {}
+
+  size_t numVertices() const { return row_offsets->size() - 1; }
+  size_t numEdges() const { return col_vals->size(); }
+  bool hasWeights() const { return !weights->empty() || numEdges() == 0; }
+  size_t degree(VertexId v) const {
+    return (*row_offsets)[v + 1] - (*row_offsets)[v];
+  }
+  const size_t *offsets() const { return row_offsets->data(); }
+  const VertexId *cols() const { return col_vals->data(); }
+  const EdgeType *weightData() const { return weights->data(); }
+  bool isVertex(VertexId v) const { return present->empty() || (*present)[v]; }
+  size_t vertexCount() const {
+    if (present->empty())
+      return numVertices();
+    return static_cast<size_t>(
+        std::count(present->begin(), present->end(), std::uint8_t{1}));
+  }
+
+  // Copies the rows of any storage engine through its id-level views, one
+  // range of rows per pool task. Must not overlap writes to the engine.
+  template <typename Engine>
+  static CsrSnapshot fromEngine(Engine &engine,
+                                Concurrency::ThreadPool &pool) {
+    const size_t n = engine.impl_rowCount();
+    std::vector<size_t> offsets(n + 1, 0);
+    std::vector<std::uint8_t> has_row(n, 0);
+    pool.parallel_for(0, n, [&](size_t lo, size_t hi) {
+      for (size_t v = lo; v < hi; ++v) {
+        if (!engine.impl_hasRow(static_cast<VertexId>(v)))
+          continue;
+        has_row[v] = 1;
+        offsets[v + 1] =
+            engine.impl_neighborsById(static_cast<VertexId>(v)).size();
+      }
+    });
+    for (size_t v = 0; v < n; ++v)
+      offsets[v + 1] += offsets[v];
+    std::vector<VertexId> cols(offsets[n]);
+    std::vector<EdgeType> edge_weights(offsets[n]);
+    pool.parallel_for_weighted(
+        0, n, [&](size_t v) { return offsets[v] + v; },
+        [&](size_t lo, size_t hi) {
+          for (size_t v = lo; v < hi; ++v) {
+            if (offsets[v] == offsets[v + 1])
+              continue;
+            const auto view =
+                engine.impl_neighborsById(static_cast<VertexId>(v));
+            size_t out = offsets[v];
+            for (auto it = view.begin(); it != view.end(); ++it, ++out) {
+              cols[out] = it.id();
+              edge_weights[out] = it.weight();
+            }
+          }
+          sortRows(offsets, lo, hi, cols, &edge_weights);
+        });
+    CsrSnapshot out(std::move(offsets), std::move(cols),
+                    std::move(edge_weights));
+    if (std::find(has_row.begin(), has_row.end(), 0) != has_row.end())
+      out.present =
+          std::make_shared<const std::vector<std::uint8_t>>(std::move(has_row));
+    return out;
+  }
+
+  // The reverse graph: row v lists the sources of v's in-edges, sorted.
+  // Weights are carried over only if asked for; among parallel edges with
+  // different weights their order is unspecified.
+  CsrSnapshot transposed(Concurrency::ThreadPool &pool,
+                         bool with_weights = false) const {
+    const size_t n = numVertices();
+    const size_t *offsets = this->offsets();
+    const VertexId *cols = this->cols();
+    auto by_row = [offsets](size_t v) { return offsets[v] + v; };
+    std::unique_ptr<std::atomic<size_t>[]> cursor(
+        new std::atomic<size_t>[n + 1]());
+    pool.parallel_for_weighted(0, n, by_row, [&](size_t lo, size_t hi) {
+      for (size_t e = offsets[lo]; e < offsets[hi]; ++e)
+        cursor[cols[e] + 1].fetch_add(1, std::memory_order_relaxed);
+    });
+    std::vector<size_t> t_offsets(n + 1, 0);
+    for (size_t v = 0; v < n; ++v) {
+      t_offsets[v + 1] =
+          t_offsets[v] + cursor[v + 1].load(std::memory_order_relaxed);
+      cursor[v].store(t_offsets[v], std::memory_order_relaxed);
+    }
+    std::vector<VertexId> t_cols(numEdges());
+    std::vector<EdgeType> t_weights(with_weights ? numEdges() : 0);
+    pool.parallel_for_weighted(0, n, by_row, [&](size_t lo, size_t hi) {
+      for (size_t u = lo; u < hi; ++u) {
+        for (size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+          const size_t pos =
+              cursor[cols[e]].fetch_add(1, std::memory_order_relaxed);
+          t_cols[pos] = static_cast<VertexId>(u);
+          if (with_weights)
+            t_weights[pos] = (*weights)[e];
+        }
+      }
+    });
+    cursor.reset();
+    pool.parallel_for_weighted(
+        0, n, [&](size_t v) { return t_offsets[v] + v; },
+        [&](size_t lo, size_t hi) {
+          sortRows(t_offsets, lo, hi, t_cols,
+                   with_weights ? &t_weights : nullptr);
+        });
+    CsrSnapshot out(std::move(t_offsets), std::move(t_cols),
+                    std::move(t_weights));
+    out.present = present;
+    return out;
+  }
+
+private:
+  // Sorts rows [first, last) by destination, moving weights along when
+  // given; stable so that parallel edges keep their order.
+  static void sortRows(const std::vector<size_t> &offsets, size_t first,
+                       size_t last, std::vector<VertexId> &cols,
+                       std::vector<EdgeType> *edge_weights) {
+    std::vector<std::pair<VertexId, EdgeType>> scratch;
+    for (size_t v = first; v < last; ++v) {
+      const auto begin = cols.begin() + offsets[v];
+      const auto end = cols.begin() + offsets[v + 1];
+      if (std::is_sorted(begin, end))
+        continue;
+      if (!edge_weights) {
+        std::sort(begin, end);
+        continue;
+      }
+      scratch.clear();
+      for (size_t i = offsets[v]; i < offsets[v + 1]; ++i)
+        scratch.emplace_back(cols[i], std::move((*edge_weights)[i]));
+      std::stable_sort(
+          scratch.begin(), scratch.end(),
+          [](const auto &a, const auto &b) { return a.first < b.first; });
+      for (size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+        cols[i] = scratch[i - offsets[v]].first;
+        (*edge_weights)[i] = std::move(scratch[i - offsets[v]].second);
+      }
+    }
+  }
+};
+
+} // namespace PeakStore
+} // namespace CinderPeak
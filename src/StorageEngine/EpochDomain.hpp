@@ -0,0 +1,109 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+namespace CinderPeak {
+namespace PeakStore {
+
+// Epoch-based reclamation for data that readers access without locks.
+// A reader pins the global epoch in one of MAX_READERS slots for as long as
+// it holds pointers into shared data. A writer first unlinks an object and
+// then retires it, stamping it with the epoch current at that point; the
+// object is deleted once every pinned slot carries a later epoch, since those
+// readers pinned after the unlink and cannot reach it.
+class EpochDomain {
+public:
+  static constexpr size_t MAX_READERS = 64;
+
+  class Guard {
+  public:
+    Guard() = default;
+    Guard(EpochDomain *domain, size_t slot) : domain(domain), slot(slot) {}
+    Guard(Guard &&o) noexcept
+        : domain(std::exchange(o.domain, nullptr)), slot(o.slot) {}
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+    Guard &operator=(Guard &&) = delete;
+    ~Guard() {
+      if (domain)
+        domain->slots[slot].epoch.store(IDLE, std::memory_order_release);
+    }
+
+  private:
+    EpochDomain *domain = nullptr;
+    size_t slot = 0;
+  };
+
+  EpochDomain() = default;
+  EpochDomain(const EpochDomain &) = delete;
+  EpochDomain &operator=(const EpochDomain &) = delete;
+  ~EpochDomain() {
+    for (auto &entry : retired)
+      entry.second();
+  }
+
+  // Pins the calling thread until the guard is destroyed. Spins only when all
+  // MAX_READERS slots are taken.
+  Guard pin() {
+    thread_local const size_t hint =
+        std::hash<std::thread::id>()(std::this_thread::get_id());
+    for (;;) {
+      for (size_t i = 0; i < MAX_READERS; ++i) {
+        Slot &slot = slots[(hint + i) % MAX_READERS];
+        std::uint64_t idle = IDLE;
+        if (slot.epoch.load(std::memory_order_relaxed) == IDLE &&
+            slot.epoch.compare_exchange_strong(idle, epoch.load()))
+          return Guard(this, &slot - slots);
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  // Deletes `object` once no pinned reader can still reach it. The caller
+  // must already have unlinked it from every shared pointer.
+  template <typename T> void retire(const T *object) {
+    if (!object)
+      return;
+    std::lock_guard<std::mutex> lock(retire_mutex);
+    retired.emplace_back(epoch.fetch_add(1), [object] { delete object; });
+    reclaim();
+  }
+
+private:
+  static constexpr std::uint64_t IDLE =
+      std::numeric_limits<std::uint64_t>::max();
+
+  struct alignas(64) Slot {
+    std::atomic<std::uint64_t> epoch{IDLE};
+  };
+
+  std::atomic<std::uint64_t> epoch{0};
+  Slot slots[MAX_READERS];
+  std::mutex retire_mutex;
+  std::vector<std::pair<std::uint64_t, std::function<void()>>> retired;
+
+  // Callers hold retire_mutex.
+  void reclaim() {
+    std::uint64_t oldest = IDLE;
+    for (const Slot &slot : slots)
+      oldest = std::min(oldest, slot.epoch.load());
+    size_t kept = 0;
+    for (auto &entry : retired) {
+      if (entry.first < oldest)
+        entry.second();
+      else
+        retired[kept++] = std::move(entry);
+    }
+    retired.resize(kept);
+  }
+};
+
+} // namespace PeakStore
+} // namespace CinderPeak
@@ -1,4 +1,5 @@
 #pragma once
+#include <memory>
 #include <string>
 
 namespace CinderPeak {
@@ -16,54 +17,80 @@ enum class StatusCode {
   EDGE_ALREADY_EXISTS,
 };
 
+// Result of a storage operation. The message is a pointer to a string with
+// static storage duration, so creating, copying and returning a status never
+// allocates. Context that is only known at runtime can be attached with
+// withDetail(); it is allocated once, shared between copies and freed with
+// the last of them, and stays null on the common path.
 class PeakStatus {
 private:
   StatusCode code_;
-  std::string message_;
+  const char *message_;
+  std::shared_ptr<const std::string> detail_;
 
 public:
-  PeakStatus(StatusCode code, std::string message = "")
-      : code_(code), message_(std::move(message)) {}
+  PeakStatus(StatusCode code, const char *message = "")
+      : code_(code), message_(message) {}
+  // Runtime messages are kept as detail; prefer the static overload.
+  PeakStatus(StatusCode code, std::string message)
+      : code_(code), message_(""),
+        detail_(std::make_shared<const std::string>(std::move(message))) {}
 
   inline static PeakStatus OK() { return PeakStatus(StatusCode::OK); }
-  inline static PeakStatus NotFound(std::string msg = "Not Found") {
-    return PeakStatus(StatusCode::NOT_FOUND, std::move(msg));
+  inline static PeakStatus NotFound(const char *msg = "Not Found") {
+    return PeakStatus(StatusCode::NOT_FOUND, msg);
   }
   inline static PeakStatus
-  InvalidArgument(std::string msg = "Invalid Argument") {
-    return PeakStatus(StatusCode::INVALID_ARGUMENT, std::move(msg));
+  InvalidArgument(const char *msg = "Invalid Argument") {
+    return PeakStatus(StatusCode::INVALID_ARGUMENT, msg);
   }
   inline static PeakStatus
-  VertexAlreadyExists(std::string msg = "Vertex Already Exists") {
-    return PeakStatus(StatusCode::VERTEX_ALREADY_EXISTS, std::move(msg));
+  VertexAlreadyExists(const char *msg = "Vertex Already Exists") {
+    return PeakStatus(StatusCode::VERTEX_ALREADY_EXISTS, msg);
   }
-  inline static PeakStatus AlreadyExists(std::string msg = "Already Exists") {
-    return PeakStatus(StatusCode::VERTEX_ALREADY_EXISTS, std::move(msg));
+  inline static PeakStatus AlreadyExists(const char *msg = "Already Exists") {
+    return PeakStatus(StatusCode::VERTEX_ALREADY_EXISTS, msg);
   }
-  inline static PeakStatus InternalError(std::string msg = "Internal Error") {
-    return PeakStatus(StatusCode::INTERNAL_ERROR, std::move(msg));
+  inline static PeakStatus InternalError(const char *msg = "Internal Error") {
+    return PeakStatus(StatusCode::INTERNAL_ERROR, msg);
   }
-  inline static PeakStatus EdgeNotFound(std::string msg = "Edge Not Found") {
-    return PeakStatus(StatusCode::EDGE_NOT_FOUND, std::move(msg));
+  inline static PeakStatus EdgeNotFound(const char *msg = "Edge Not Found") {
+    return PeakStatus(StatusCode::EDGE_NOT_FOUND, msg);
   }
   inline static PeakStatus
-  VertexNotFound(std::string msg = "Vertex Not Found") {
-    return PeakStatus(StatusCode::VERTEX_NOT_FOUND, std::move(msg));
+  VertexNotFound(const char *msg = "Vertex Not Found") {
+    return PeakStatus(StatusCode::VERTEX_NOT_FOUND, msg);
   }
   inline static PeakStatus MethodNotImplemented(
-      std::string msg = "Method is not implemented, there has been an error.") {
-    return PeakStatus(StatusCode::UNIMPLEMENTED, std::move(msg));
+      const char *msg = "Method is not implemented, there has been an error.") {
+    return PeakStatus(StatusCode::UNIMPLEMENTED, msg);
   }
   inline static PeakStatus
-  EdgeAlreadyExists(std::string msg = "Edge Already Exists") {
-    return PeakStatus(StatusCode::EDGE_ALREADY_EXISTS, std::move(msg));
+  EdgeAlreadyExists(const char *msg = "Edge Already Exists") {
+    return PeakStatus(StatusCode::EDGE_ALREADY_EXISTS, msg);
   }
+
+  // Returns a copy of this status carrying `detail` as well.
+  PeakStatus withDetail(std::string detail) const {
+    PeakStatus status(code_, message_);
+    status.detail_ = std::make_shared<const std::string>(std::move(detail));
+    return status;
+  }
+
   bool isOK() const { return code_ == StatusCode::OK; }
   StatusCode code() const { return code_; }
-  std::string message() const { return message_; }
+  const char *staticMessage() const { return message_; }
+  const std::string *detail() const { return detail_.get(); }
+  std::string message() const {
+    if (!detail_)
+      return message_;
+    if (*message_ == '\0')
+      return *detail_;
+    return std::string(message_) + ": " + *detail_;
+  }
 
   std::string toString() const {
-    return "[" + std::to_string(static_cast<int>(code_)) + "] " + message_;
+    return "[" + std::to_string(static_cast<int>(code_)) + "] " + message();
   }
 };
 
@@ -1,24 +1,36 @@
 #pragma once
+#include "Concurrency/ThreadPool.hpp"
 #include "PeakLogger.hpp"
+#include "StorageEngine/StoreStats.hpp"
 #include "StorageEngine/Utils.hpp"
 #include "StorageInterface.hpp"
 #include "Visualizer.hpp"
 #include <memory>
 namespace CinderPeak {
+template <typename, typename> class PeakStorageInterface;
 namespace PeakStore {
 
 // Forward declarations
 template <typename VertexType, typename EdgeType> class AdjacencyList;
 template <typename VertexType, typename EdgeType> class HybridCSR_COO;
+template <typename VertexType, typename EdgeType> class AdjacencyMatrix;
+template <typename VertexType> class VertexDictionary;
 // template <typename VertexType, typename EdgeType> class CoordinateList;
 
 template <typename VertexType, typename EdgeType> class GraphContext {
 public:
   std::shared_ptr<GraphInternalMetadata> metadata = nullptr;
   std::shared_ptr<GraphCreationOptions> create_options = nullptr;
+  // Shared by every storage engine so that vertex ids agree across engines.
+  std::shared_ptr<VertexDictionary<VertexType>> vertex_dictionary = nullptr;
+  std::shared_ptr<Concurrency::ThreadPool> thread_pool = nullptr;
+  // Null unless GraphCreationOptions::Instrumented is set.
+  std::shared_ptr<StoreStats> stats = nullptr;
   std::shared_ptr<HybridCSR_COO<VertexType, EdgeType>> hybrid_storage = nullptr;
   std::shared_ptr<AdjacencyList<VertexType, EdgeType>> adjacency_storage =
       nullptr;
+  std::shared_ptr<AdjacencyMatrix<VertexType, EdgeType>> matrix_storage =
+      nullptr;
   //   std::shared_ptr<CoordinateList<VertexType, EdgeType>> coordinate_list =
   //       nullptr;
   std::shared_ptr<PeakStorageInterface<VertexType, EdgeType>> active_storage =
@@ -0,0 +1,157 @@
+#pragma once
+#include "StorageEngine/NeighborView.hpp"
+#include "StorageEngine/VertexDictionary.hpp"
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+namespace CinderPeak {
+template <typename, typename> class PeakStorageInterface;
+namespace PeakStore {
+
+// Whole-graph iteration over a storage engine in vertex id order. Both
+// ranges read engine storage in place and, like NeighborView, are
+// invalidated by any write to the graph. `Storage` is the interface for
+// runtime-selected engines or a concrete engine under StaticStorage.
+template <typename VertexType, typename EdgeType,
+          typename Storage = PeakStorageInterface<VertexType, EdgeType>>
+class VertexRange {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = VertexType;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const VertexType *;
+    using reference = const VertexType &;
+
+    iterator() = default;
+    iterator(const VertexRange *range, VertexId row)
+        : range(range), row(row) {
+      skipAbsent();
+    }
+
+    VertexId id() const { return row; }
+    reference operator*() const { return range->dictionary->vertex(row); }
+    pointer operator->() const { return &**this; }
+    iterator &operator++() {
+      ++row;
+      skipAbsent();
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator prev = *this;
+      ++*this;
+      return prev;
+    }
+    bool operator==(const iterator &o) const { return row == o.row; }
+    bool operator!=(const iterator &o) const { return row != o.row; }
+
+  private:
+    const VertexRange *range = nullptr;
+    VertexId row = 0;
+
+    void skipAbsent() {
+      while (row < range->rows && !range->storage->impl_hasRow(row))
+        ++row;
+    }
+  };
+  using const_iterator = iterator;
+
+  VertexRange(const Storage *storage,
+              const VertexDictionary<VertexType> *dictionary)
+      : storage(storage), dictionary(dictionary),
+        rows(static_cast<VertexId>(storage->impl_rowCount())) {}
+
+  iterator begin() const { return {this, 0}; }
+  iterator end() const { return {this, rows}; }
+
+private:
+  const Storage *storage;
+  const VertexDictionary<VertexType> *dictionary;
+  VertexId rows;
+};
+
+// Yields (src, dest, weight) for every edge, grouped by source vertex.
+template <typename VertexType, typename EdgeType,
+          typename Storage = PeakStorageInterface<VertexType, EdgeType>>
+class EdgeRange {
+public:
+  using View = NeighborView<VertexType, EdgeType>;
+
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::tuple<const VertexType &, const VertexType &,
+                                  const EdgeType &>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    iterator() = default;
+    iterator(Storage *storage, const VertexDictionary<VertexType> *dictionary,
+             VertexId row, VertexId rows)
+        : storage(storage), dictionary(dictionary), row(row), rows(rows) {
+      if (row < rows && storage->impl_hasRow(row))
+        view = storage->impl_neighborsById(row);
+      cursor = view.first();
+      settle();
+    }
+
+    VertexId srcId() const { return row; }
+    VertexId destId() const { return view.idAt(cursor); }
+    const EdgeType &weight() const { return view.weightAt(cursor); }
+    reference operator*() const {
+      return {dictionary->vertex(row), view.vertexAt(cursor), weight()};
+    }
+    iterator &operator++() {
+      view.advance(cursor);
+      settle();
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator prev = *this;
+      ++*this;
+      return prev;
+    }
+    bool operator==(const iterator &o) const {
+      return row == o.row && (row == rows || cursor == o.cursor);
+    }
+    bool operator!=(const iterator &o) const { return !(*this == o); }
+
+  private:
+    Storage *storage = nullptr;
+    const VertexDictionary<VertexType> *dictionary = nullptr;
+    VertexId row = 0;
+    VertexId rows = 0;
+    View view;
+    typename View::Cursor cursor;
+
+    // Moves to the next source row that has an edge left.
+    void settle() {
+      while (row < rows && cursor == view.last()) {
+        if (++row == rows)
+          break;
+        if (!storage->impl_hasRow(row))
+          continue;
+        view = storage->impl_neighborsById(row);
+        cursor = view.first();
+      }
+    }
+  };
+  using const_iterator = iterator;
+
+  EdgeRange(Storage *storage, const VertexDictionary<VertexType> *dictionary)
+      : storage(storage), dictionary(dictionary),
+        rows(static_cast<VertexId>(storage->impl_rowCount())) {}
+
+  iterator begin() const { return {storage, dictionary, 0, rows}; }
+  iterator end() const { return {storage, dictionary, rows, rows}; }
+
+private:
+  Storage *storage;
+  const VertexDictionary<VertexType> *dictionary;
+  VertexId rows;
+};
+
+} // namespace PeakStore
+} // namespace CinderPeak
@@ -1,225 +1,1003 @@
 #pragma once
 #include "../StorageInterface.hpp"
+#include "Concurrency/ThreadPool.hpp"
+#include "StorageEngine/ConcurrentBitset.hpp"
+#include "StorageEngine/CsrSnapshot.hpp"
+#include "StorageEngine/EpochDomain.hpp"
 #include "StorageEngine/GraphContext.hpp"
+#include "StorageEngine/NeighborView.hpp"
+#include "StorageEngine/StoreStats.hpp"
+#include "StorageEngine/VertexDictionary.hpp"
 #include "Utils.hpp"
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 namespace CinderPeak {
 template <typename, typename> class PeakStorageInterface;
 namespace PeakStore {
 
+// Writers must be serialized by the caller; readers may run concurrently
+// with them and with each other. Vertex insertions write the dictionary that
+// every reader looks ids up in, so they may only overlap reads when the
+// dictionary is concurrent. Neighbor views keep the generation they point
+// into alive, so they stay valid across writes.
 template <typename VertexType, typename EdgeType>
-class HybridCSR_COO : public PeakStorageInterface<VertexType, EdgeType> {
+class HybridCSR_COO final
+    : public PeakStorageInterface<VertexType, EdgeType> {
 private:
-  alignas(64) std::vector<size_t> csr_row_offsets;
-  alignas(64) std::vector<VertexType> csr_col_vals;
-  alignas(64) std::vector<EdgeType> csr_weights;
+  // Edges added after the CSR is built are staged per row instead of
+  // rebuilding the CSR on every insert. Reads consult a row's RowDelta
+  // alongside its CSR row; mergeDelta() folds all of them back in one pass.
+  struct DeltaEdge {
+    VertexId dest;
+    EdgeType weight;
+  };
+  // Append-only storage for the staged edges of one row. Generations share
+  // it and each reads only the first RowDelta::size entries, so the writer
+  // appends past them without copying the row.
+  struct DeltaLog {
+    explicit DeltaLog(size_t capacity)
+        : edges(new DeltaEdge[capacity]), capacity(capacity) {}
+    std::unique_ptr<DeltaEdge[]> edges;
+    size_t capacity;
+    // Entries written so far; only the writer touches this.
+    size_t used = 0;
+  };
+  using Patches = std::vector<WeightPatch<EdgeType>>;
+  struct RowDelta {
+    std::shared_ptr<DeltaLog> log;
+    size_t size = 0;
+    // log->edges[0, sorted) is sorted by dest. The rest follows in insertion
+    // order until it outgrows tailLimit() and is sorted in.
+    size_t sorted = 0;
+    // Updated weights by position in the row, CSR edges first and then the
+    // log, so that an update copies neither. Updates go to the short
+    // `recent` list, which wins over `patches` and is merged into it once
+    // it outgrows tailLimit().
+    std::shared_ptr<const Patches> patches;
+    std::shared_ptr<const Patches> recent;
 
-  std::vector<VertexType> coo_src;
-  std::vector<VertexType> coo_dest;
+    const DeltaEdge *edges() const { return log ? log->edges.get() : nullptr; }
+    size_t patchCount() const {
+      return (patches ? patches->size() : 0) + (recent ? recent->size() : 0);
+    }
+    // What the row adds to Generation::delta_size.
+    size_t entries() const { return size + patchCount(); }
+  };
+
+  // Row deltas are reached through a persistent radix trie over the row id,
+  // DELTA_FANOUT slots per node. Staging an edge copies that row's RowDelta
+  // header and the nodes on its path and shares everything else with the
+  // previous generation, so an insert never copies the whole delta.
+  static constexpr unsigned DELTA_BITS = 5;
+  static constexpr size_t DELTA_FANOUT = size_t{1} << DELTA_BITS;
+  struct DeltaNode {
+    // DeltaNodes below the leaves, RowDeltas in them.
+    std::array<std::shared_ptr<const void>, DELTA_FANOUT> slots;
+  };
+  using StagedRows =
+      std::vector<std::pair<VertexId, std::shared_ptr<const RowDelta>>>;
+
+  // One immutable CSR generation and its delta. Rows and columns are
+  // VertexIds from the shared dictionary, so row `i` belongs to the vertex
+  // with id `i`; rows past the end of csr_row_offsets have no CSR edges yet.
+  // A published generation is never modified. Writers build the next one,
+  // sharing the arrays that did not change, swap it in and retire the old
+  // one to the epoch domain, so readers never take a lock.
+  struct Generation : std::enable_shared_from_this<Generation> {
+    std::shared_ptr<const std::vector<size_t>> csr_row_offsets;
+    std::shared_ptr<const std::vector<VertexId>> csr_col_vals;
+    std::shared_ptr<const std::vector<EdgeType>> csr_weights;
+    // Root of the row-delta trie, null while nothing is staged. It has
+    // delta_levels levels of inner nodes above the leaves.
+    std::shared_ptr<const DeltaNode> delta;
+    unsigned delta_levels = 0;
+    // Entries across all row deltas, weight patches included.
+    size_t delta_size = 0;
+    // Edges inserted since the CSR was built.
+    size_t staged_edges = 0;
+  };
+  using GenerationPtr = std::shared_ptr<const Generation>;
+
+  // A row as readers see it: [start, end) of the CSR arrays, then `delta`.
+  struct RowParts {
+    size_t start = 0;
+    size_t end = 0;
+    const RowDelta *delta = nullptr;
+  };
+
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  std::shared_ptr<VertexDictionary<VertexType>> vertices;
+  std::shared_ptr<Concurrency::ThreadPool> pool;
+  // Rebuilds are timed into this when the owning store is instrumented.
+  std::shared_ptr<StoreStats> stats;
+  ConcurrentBitset vertex_present;
+  std::atomic<size_t> row_count{0};
+
+  mutable EpochDomain epochs;
+  // The writer's reference to the published generation. Each retired
+  // generation is released through the epoch domain, and views add their
+  // own references.
+  GenerationPtr owned;
+  std::atomic<const Generation *> current;
+
+  // Filled by impl_addEdgeById and folded into the CSR by flush(); readers
+  // do not see it until then.
+  std::vector<VertexId> coo_src;
+  std::vector<VertexId> coo_dest;
   std::vector<EdgeType> coo_weights;
 
-  std::vector<VertexType> vertex_order;
-  std::unordered_map<VertexType, size_t, VertexHasher<VertexType>>
-      vertex_to_index;
+  size_t delta_min_edges{4096};
+  double delta_ratio{0.05};
 
-  bool is_built{false};
+  size_t numRows() const { return row_count.load(std::memory_order_acquire); }
 
-  void buildStructures() {
-    if (is_built)
-      return;
-    is_built = true;
+  // Returns the id of `v` if it has been added to this engine.
+  VertexId rowOf(const VertexType &v) const {
+    VertexId id = vertices->find(v);
+    if (id == INVALID_VERTEX_ID || !vertex_present.test(id))
+      return INVALID_VERTEX_ID;
+    return id;
+  }
 
-    const size_t num_vertices = vertex_order.size();
-    csr_row_offsets.assign(num_vertices + 1, 0);
-    csr_col_vals.clear();
-    csr_weights.clear();
+  // Readers call this under an epoch guard; writers own the generation and
+  // may call it freely.
+  const Generation &published() const { return *current.load(); }
+  void publish(GenerationPtr next) {
+    current.store(next.get());
+    epochs.retire(new GenerationPtr(std::exchange(owned, std::move(next))));
+  }
+
+  static GenerationPtr makeGeneration(std::vector<size_t> row_offsets,
+                                      std::vector<VertexId> col_vals,
+                                      std::vector<EdgeType> weights) {
+    auto gen = std::make_shared<Generation>();
+    gen->csr_row_offsets =
+        std::make_shared<const std::vector<size_t>>(std::move(row_offsets));
+    gen->csr_col_vals =
+        std::make_shared<const std::vector<VertexId>>(std::move(col_vals));
+    gen->csr_weights =
+        std::make_shared<const std::vector<EdgeType>>(std::move(weights));
+    return gen;
+  }
 
-    for (size_t i = 0; i < coo_src.size(); ++i) {
-      if (vertex_to_index.count(coo_src[i])) {
-        size_t idx = vertex_to_index[coo_src[i]];
-        csr_row_offsets[idx + 1]++;
+  static size_t slotOf(VertexId row, unsigned level) {
+    return static_cast<size_t>(std::uint64_t{row} >> (DELTA_BITS * level)) &
+           (DELTA_FANOUT - 1);
+  }
+  // Whether a trie with `levels` inner levels has a leaf slot for `row`.
+  static bool trieCovers(unsigned levels, VertexId row) {
+    const unsigned bits = DELTA_BITS * (levels + 1);
+    return bits >= 64 || (std::uint64_t{row} >> bits) == 0;
+  }
+  static const RowDelta *rowDelta(const Generation &gen, VertexId row) {
+    const DeltaNode *node = gen.delta.get();
+    if (!node || !trieCovers(gen.delta_levels, row))
+      return nullptr;
+    for (unsigned level = gen.delta_levels; level > 0; --level) {
+      node = static_cast<const DeltaNode *>(
+          node->slots[slotOf(row, level)].get());
+      if (!node)
+        return nullptr;
+    }
+    return static_cast<const RowDelta *>(node->slots[slotOf(row, 0)].get());
+  }
+  // Copies `node` with the rows of [first, last), which are sorted by row
+  // and all fall under it, replaced. Untouched subtrees are shared.
+  static std::shared_ptr<const DeltaNode>
+  withRows(const DeltaNode *node, unsigned level,
+           typename StagedRows::const_iterator first,
+           typename StagedRows::const_iterator last) {
+    auto next = node ? std::make_shared<DeltaNode>(*node)
+                     : std::make_shared<DeltaNode>();
+    while (first != last) {
+      const size_t slot = slotOf(first->first, level);
+      auto group_end = std::find_if(first, last, [&](const auto &staged) {
+        return slotOf(staged.first, level) != slot;
+      });
+      if (level == 0)
+        next->slots[slot] = first->second;
+      else
+        next->slots[slot] = withRows(
+            static_cast<const DeltaNode *>(next->slots[slot].get()),
+            level - 1, first, group_end);
+      first = group_end;
+    }
+    return next;
+  }
+  // The generation with the row deltas in `rows` (sorted by row, one entry
+  // per row) replaced, and `inserted` more edges staged.
+  static GenerationPtr withRowDeltas(const Generation &gen,
+                                     const StagedRows &rows, size_t inserted) {
+    auto next = std::make_shared<Generation>();
+    next->csr_row_offsets = gen.csr_row_offsets;
+    next->csr_col_vals = gen.csr_col_vals;
+    next->csr_weights = gen.csr_weights;
+    next->delta_size = gen.delta_size;
+    for (const auto &[row, delta] : rows) {
+      const RowDelta *old = rowDelta(gen, row);
+      next->delta_size += delta->entries();
+      next->delta_size -= old ? old->entries() : 0;
+    }
+    next->staged_edges = gen.staged_edges + inserted;
+    next->delta = gen.delta;
+    next->delta_levels = gen.delta_levels;
+    if (rows.empty())
+      return next;
+    std::shared_ptr<const DeltaNode> root = gen.delta;
+    unsigned levels = root ? gen.delta_levels : 0;
+    while (!trieCovers(levels, rows.back().first)) {
+      if (root) {
+        auto grown = std::make_shared<DeltaNode>();
+        grown->slots[0] = std::move(root);
+        root = std::move(grown);
       }
+      ++levels;
+    }
+    next->delta = withRows(root.get(), levels, rows.begin(), rows.end());
+    next->delta_levels = levels;
+    return next;
+  }
+  // Calls fn(row, delta) for every row with staged edges, in row order.
+  template <typename Fn>
+  static void forEachRowDelta(const DeltaNode *node, unsigned level,
+                              std::uint64_t base, Fn &fn) {
+    for (size_t slot = 0; slot < DELTA_FANOUT; ++slot) {
+      const void *child = node->slots[slot].get();
+      if (!child)
+        continue;
+      const std::uint64_t prefix =
+          base | (std::uint64_t{slot} << (DELTA_BITS * level));
+      if (level == 0)
+        fn(static_cast<VertexId>(prefix),
+           *static_cast<const RowDelta *>(child));
+      else
+        forEachRowDelta(static_cast<const DeltaNode *>(child), level - 1,
+                        prefix, fn);
     }
+  }
+  static std::vector<std::pair<VertexId, const RowDelta *>>
+  stagedRows(const Generation &gen) {
+    std::vector<std::pair<VertexId, const RowDelta *>> rows;
+    auto collect = [&rows](VertexId row, const RowDelta &delta) {
+      rows.emplace_back(row, &delta);
+    };
+    if (gen.delta)
+      forEachRowDelta(gen.delta.get(), gen.delta_levels, 0, collect);
+    return rows;
+  }
 
-    for (size_t i = 1; i <= num_vertices; ++i) {
-      csr_row_offsets[i] += csr_row_offsets[i - 1];
+  static std::pair<size_t, size_t> csrRange(const Generation &gen,
+                                            VertexId row) {
+    const auto &offsets = *gen.csr_row_offsets;
+    if (size_t{row} + 1 >= offsets.size())
+      return {0, 0};
+    return {offsets[row], offsets[row + 1]};
+  }
+  static RowParts rowParts(const Generation &gen, VertexId row) {
+    RowParts parts;
+    parts.delta = rowDelta(gen, row);
+    std::tie(parts.start, parts.end) = csrRange(gen, row);
+    return parts;
+  }
+  static bool deltaLess(const DeltaEdge &a, const DeltaEdge &b) {
+    return a.dest < b.dest;
+  }
+  static bool patchBefore(const WeightPatch<EdgeType> &patch, size_t pos) {
+    return patch.pos < pos;
+  }
+  // The patches of `list` with positions in [lo, hi).
+  static PatchRange<EdgeType>
+  patchRange(const std::shared_ptr<const Patches> &list, size_t lo = 0,
+             size_t hi = npos) {
+    PatchRange<EdgeType> range;
+    if (!list)
+      return range;
+    auto first = std::lower_bound(list->begin(), list->end(), lo, patchBefore);
+    auto last = hi == npos ? list->end()
+                           : std::lower_bound(first, list->end(), hi,
+                                              patchBefore);
+    range.first = list->data() + (first - list->begin());
+    range.count = static_cast<size_t>(last - first);
+    return range;
+  }
+  // One sorted list of the patches in both ranges, `newer` winning ties.
+  static std::shared_ptr<const Patches>
+  mergedPatches(PatchRange<EdgeType> newer, PatchRange<EdgeType> older) {
+    auto out = std::make_shared<Patches>();
+    out->reserve(newer.count + older.count);
+    size_t i = 0, j = 0;
+    while (i < newer.count || j < older.count) {
+      if (j == older.count ||
+          (i < newer.count && newer.first[i].pos <= older.first[j].pos)) {
+        j += j < older.count && older.first[j].pos == newer.first[i].pos;
+        out->push_back(newer.first[i++]);
+      } else {
+        out->push_back(older.first[j++]);
+      }
+    }
+    return out;
+  }
+  // The updated weight at `pos` of the row, counting CSR edges first, or
+  // nullptr.
+  static const EdgeType *patchAt(const RowDelta *delta, size_t pos) {
+    if (!delta || !(delta->patches || delta->recent))
+      return nullptr;
+    if (const EdgeType *patched = patchRange(delta->recent).find(pos))
+      return patched;
+    return patchRange(delta->patches).find(pos);
+  }
+  // Position of the first edge to `dest` in the CSR arrays, or npos.
+  static size_t findInCSR(const Generation &gen, const RowParts &parts,
+                          VertexId dest) {
+    const auto &cols = *gen.csr_col_vals;
+    auto first = cols.begin() + parts.start, last = cols.begin() + parts.end;
+    auto it = std::lower_bound(first, last, dest);
+    if (it != last && *it == dest)
+      return static_cast<size_t>(it - cols.begin());
+    return npos;
+  }
+  // Position of the first edge to `dest` in the row's log, or npos.
+  static size_t findInDelta(const RowParts &parts, VertexId dest) {
+    if (!parts.delta)
+      return npos;
+    const RowDelta &delta = *parts.delta;
+    const DeltaEdge *edges = delta.edges();
+    const DeltaEdge *sorted_end = edges + delta.sorted;
+    const DeltaEdge *it = std::lower_bound(
+        edges, sorted_end, DeltaEdge{dest, EdgeType{}}, deltaLess);
+    if (it != sorted_end && it->dest == dest)
+      return static_cast<size_t>(it - edges);
+    for (size_t i = delta.sorted; i < delta.size; ++i) {
+      if (edges[i].dest == dest)
+        return i;
     }
+    return npos;
+  }
+  // Weight of the first (row, dest) edge in the CSR or the delta, or
+  // nullptr.
+  static const EdgeType *findEdge(const Generation &gen, VertexId row,
+                                  VertexId dest) {
+    const RowParts parts = rowParts(gen, row);
+    if (size_t pos = findInCSR(gen, parts, dest); pos != npos) {
+      const EdgeType *patched = patchAt(parts.delta, pos - parts.start);
+      return patched ? patched : &(*gen.csr_weights)[pos];
+    }
+    if (size_t pos = findInDelta(parts, dest); pos != npos) {
+      const EdgeType *patched =
+          patchAt(parts.delta, parts.end - parts.start + pos);
+      return patched ? patched : &parts.delta->edges()[pos].weight;
+    }
+    return nullptr;
+  }
+  template <typename Fn>
+  static void forEachInRow(const Generation &gen, VertexId row, Fn &&fn) {
+    const RowParts parts = rowParts(gen, row);
+    const size_t csr_size = parts.end - parts.start;
+    const bool patched = parts.delta && parts.delta->patchCount();
+    auto weightAt = [&](size_t pos,
+                        const EdgeType &stored) -> const EdgeType & {
+      const EdgeType *patch = patched ? patchAt(parts.delta, pos) : nullptr;
+      return patch ? *patch : stored;
+    };
+    for (size_t i = 0; i < csr_size; ++i)
+      fn((*gen.csr_col_vals)[parts.start + i],
+         weightAt(i, (*gen.csr_weights)[parts.start + i]));
+    if (parts.delta) {
+      const DeltaEdge *edges = parts.delta->edges();
+      for (size_t i = 0; i < parts.delta->size; ++i)
+        fn(edges[i].dest, weightAt(csr_size + i, edges[i].weight));
+    }
+  }
+
+  // The row's staged edges sorted by dest, parallel edges in insertion
+  // order, with their patches applied.
+  static std::vector<DeltaEdge> sortedDelta(const RowParts &parts) {
+    std::vector<DeltaEdge> out;
+    const RowDelta *delta = parts.delta;
+    if (!delta)
+      return out;
+    out.assign(delta->edges(), delta->edges() + delta->size);
+    const size_t csr_size = parts.end - parts.start;
+    // Older patches first, so that recent ones overwrite them.
+    for (const auto *list : {&delta->patches, &delta->recent}) {
+      const PatchRange<EdgeType> range = patchRange(*list, csr_size);
+      for (size_t i = 0; i < range.count; ++i)
+        out[range.first[i].pos - csr_size].weight = range.first[i].weight;
+    }
+    const auto tail = out.begin() + delta->sorted;
+    std::stable_sort(tail, out.end(), deltaLess);
+    std::inplace_merge(out.begin(), tail, out.end(), deltaLess);
+    return out;
+  }
+  // The patches on the row's CSR edges, which outlive rewrites of its log.
+  static std::shared_ptr<const Patches> csrPatches(const RowParts &parts) {
+    const RowDelta *delta = parts.delta;
+    if (!delta || !delta->patchCount())
+      return nullptr;
+    const size_t csr_size = parts.end - parts.start;
+    const PatchRange<EdgeType> recent = patchRange(delta->recent, 0, csr_size);
+    const PatchRange<EdgeType> older = patchRange(delta->patches, 0, csr_size);
+    if (recent.count + older.count == 0)
+      return nullptr;
+    if (!recent.count && older.count == delta->patches->size())
+      return delta->patches;
+    return mergedPatches(recent, older);
+  }
+  // A delta holding `edges`, which are sorted, with room to append.
+  static std::shared_ptr<RowDelta>
+  sortedRowDelta(std::vector<DeltaEdge> edges,
+                 std::shared_ptr<const Patches> patches) {
+    auto delta = std::make_shared<RowDelta>();
+    if (!edges.empty()) {
+      delta->log = std::make_shared<DeltaLog>(2 * edges.size());
+      std::move(edges.begin(), edges.end(), delta->log->edges.get());
+      delta->log->used = delta->size = delta->sorted = edges.size();
+    }
+    delta->patches = std::move(patches);
+    return delta;
+  }
+
+  static constexpr size_t DELTA_TAIL_MIN = 32;
+  // Unsorted entries a log holds before they are sorted in. About the
+  // square root of its sorted part, which balances scanning the tail on
+  // lookups against re-sorting the row.
+  static size_t tailLimit(size_t sorted) {
+    return std::max(DELTA_TAIL_MIN, static_cast<size_t>(std::sqrt(
+                                        static_cast<double>(sorted))));
+  }
+  // The row's delta with `edge` appended.
+  static std::shared_ptr<const RowDelta> appendedRow(const RowParts &parts,
+                                                     DeltaEdge edge) {
+    auto next = parts.delta ? std::make_shared<RowDelta>(*parts.delta)
+                            : std::make_shared<RowDelta>();
+    DeltaLog *log = next->log.get();
+    if (!log || log->used != next->size || next->size == log->capacity) {
+      auto grown =
+          std::make_shared<DeltaLog>(std::max(DELTA_TAIL_MIN, 2 * next->size));
+      std::copy(next->edges(), next->edges() + next->size,
+                grown->edges.get());
+      grown->used = next->size;
+      next->log = std::move(grown);
+      log = next->log.get();
+    }
+    log->edges[log->used++] = std::move(edge);
+    ++next->size;
+    if (next->size - next->sorted > tailLimit(next->sorted)) {
+      RowParts appended = parts;
+      appended.delta = next.get();
+      next = sortedRowDelta(sortedDelta(appended), csrPatches(appended));
+    }
+    return next;
+  }
+  // The row's delta with the weight at `pos` replaced.
+  static std::shared_ptr<const RowDelta>
+  patchedRow(const RowParts &parts, size_t pos, const EdgeType &weight) {
+    auto next = parts.delta ? std::make_shared<RowDelta>(*parts.delta)
+                            : std::make_shared<RowDelta>();
+    auto recent = next->recent ? std::make_shared<Patches>(*next->recent)
+                               : std::make_shared<Patches>();
+    auto it = std::lower_bound(recent->begin(), recent->end(), pos,
+                               patchBefore);
+    if (it != recent->end() && it->pos == pos)
+      it->weight = weight;
+    else
+      recent->insert(it, {pos, weight});
+    const size_t settled = next->patches ? next->patches->size() : 0;
+    if (recent->size() > tailLimit(settled)) {
+      next->patches = mergedPatches({recent->data(), recent->size()},
+                                    patchRange(next->patches));
+      next->recent = nullptr;
+    } else {
+      next->recent = std::move(recent);
+    }
+    return next;
+  }
+
+  // Builds below this many edges per worker run on the calling thread.
+  static constexpr size_t PARALLEL_BUILD_GRAIN = size_t{1} << 16;
+
+  static size_t buildWorkers(const Concurrency::ThreadPool &pool,
+                             size_t num_vertices, size_t num_edges) {
+    // Each worker keeps a degree histogram over every row; their combined
+    // size is capped at the size of the edge list.
+    const size_t by_memory = num_edges / (num_vertices + 1);
+    const size_t by_work = num_edges / PARALLEL_BUILD_GRAIN;
+    return std::max<size_t>(1, std::min({pool.size(), by_memory, by_work}));
+  }
+  // Runs fn(0) .. fn(workers - 1) on the pool and waits for them.
+  template <typename Fn>
+  static void runWorkers(Concurrency::ThreadPool &pool, size_t workers,
+                         Fn &&fn) {
+    pool.parallel_for(
+        0, workers,
+        [&fn](size_t lo, size_t hi) {
+          for (size_t w = lo; w < hi; ++w)
+            fn(w);
+        },
+        1);
+  }
 
-    csr_col_vals.resize(csr_row_offsets[num_vertices]);
-    csr_weights.resize(csr_row_offsets[num_vertices]);
+  // Counting-sort construction split across workers. Each worker counts the
+  // degrees of its slice of the COO arrays into its own histogram. A prefix
+  // sum over (row, worker) turns the histograms into row offsets plus one
+  // write cursor per worker and row, so the scatter needs no atomics and
+  // keeps parallel edges in input order. Rows are then sorted in place by
+  // destination, with rows split by degree so that hub rows do not serialize
+  // the sort.
+  static GenerationPtr
+  buildGeneration(Concurrency::ThreadPool &pool, size_t num_vertices,
+                  const std::vector<VertexId> &src,
+                  const std::vector<VertexId> &dest,
+                  std::vector<EdgeType> &weights) {
+    const size_t num_edges = src.size();
+    const size_t workers = buildWorkers(pool, num_vertices, num_edges);
+    auto slice = [&](size_t w, size_t n) {
+      return std::make_pair(n * w / workers, n * (w + 1) / workers);
+    };
 
-    std::vector<size_t> insert_offsets = csr_row_offsets;
-    std::vector<std::vector<std::pair<VertexType, EdgeType>>> temp_rows(
-        num_vertices);
-    for (size_t i = 0; i < coo_src.size(); ++i) {
-      if (vertex_to_index.count(coo_src[i]) &&
-          vertex_to_index.count(coo_dest[i])) {
-        size_t row = vertex_to_index[coo_src[i]];
-        temp_rows[row].emplace_back(coo_dest[i], coo_weights[i]);
+    std::vector<std::vector<size_t>> cursors(workers);
+    runWorkers(pool, workers, [&](size_t w) {
+      auto &counts = cursors[w];
+      counts.assign(num_vertices, 0);
+      const auto [first, last] = slice(w, num_edges);
+      for (size_t i = first; i < last; ++i)
+        counts[src[i]]++;
+    });
+
+    // Row totals and one partial sum per block of rows, then a short serial
+    // scan over the blocks.
+    std::vector<size_t> row_offsets(num_vertices + 1, 0);
+    std::vector<size_t> block_sums(workers + 1, 0);
+    runWorkers(pool, workers, [&](size_t w) {
+      const auto [first, last] = slice(w, num_vertices);
+      size_t sum = 0;
+      for (size_t row = first; row < last; ++row) {
+        for (size_t t = 0; t < workers; ++t)
+          sum += cursors[t][row];
+      }
+      block_sums[w + 1] = sum;
+    });
+    for (size_t w = 0; w < workers; ++w)
+      block_sums[w + 1] += block_sums[w];
+    runWorkers(pool, workers, [&](size_t w) {
+      const auto [first, last] = slice(w, num_vertices);
+      size_t offset = block_sums[w];
+      for (size_t row = first; row < last; ++row) {
+        row_offsets[row] = offset;
+        for (size_t t = 0; t < workers; ++t) {
+          const size_t count = cursors[t][row];
+          cursors[t][row] = offset;
+          offset += count;
+        }
+      }
+    });
+    row_offsets[num_vertices] = num_edges;
+
+    std::vector<VertexId> col_vals(num_edges);
+    std::vector<EdgeType> csr_weights(num_edges);
+    runWorkers(pool, workers, [&](size_t w) {
+      auto &cursor = cursors[w];
+      const auto [first, last] = slice(w, num_edges);
+      for (size_t i = first; i < last; ++i) {
+        const size_t pos = cursor[src[i]]++;
+        col_vals[pos] = dest[i];
+        csr_weights[pos] = std::move(weights[i]);
       }
+    });
+    cursors.clear();
+    cursors.shrink_to_fit();
+
+    if (workers == 1) {
+      sortRows(row_offsets, 0, num_vertices, col_vals, csr_weights);
+    } else {
+      pool.parallel_for_weighted(
+          0, num_vertices,
+          [&](size_t row) { return row_offsets[row] + row; },
+          [&](size_t first, size_t last) {
+            sortRows(row_offsets, first, last, col_vals, csr_weights);
+          },
+          PARALLEL_BUILD_GRAIN);
     }
+    return makeGeneration(std::move(row_offsets), std::move(col_vals),
+                          std::move(csr_weights));
+  }
 
-    for (size_t row = 0; row < num_vertices; ++row) {
-      std::sort(temp_rows[row].begin(), temp_rows[row].end(),
-                [](const auto &a, const auto &b) { return a.first < b.first; });
-      for (const auto &[dest, weight] : temp_rows[row]) {
-        size_t pos = insert_offsets[row]++;
-        csr_col_vals[pos] = dest;
-        csr_weights[pos] = weight;
+  static void sortRows(const std::vector<size_t> &row_offsets,
+                       size_t first_row, size_t last_row,
+                       std::vector<VertexId> &col_vals,
+                       std::vector<EdgeType> &weights) {
+    std::vector<std::pair<VertexId, EdgeType>> scratch;
+    for (size_t row = first_row; row < last_row; ++row) {
+      const size_t start = row_offsets[row];
+      const size_t end = row_offsets[row + 1];
+      if (std::is_sorted(col_vals.begin() + start, col_vals.begin() + end))
+        continue;
+      scratch.clear();
+      for (size_t i = start; i < end; ++i)
+        scratch.emplace_back(col_vals[i], std::move(weights[i]));
+      // Stable so that parallel edges keep their insertion order.
+      std::stable_sort(
+          scratch.begin(), scratch.end(),
+          [](const auto &a, const auto &b) { return a.first < b.first; });
+      for (size_t i = start; i < end; ++i) {
+        col_vals[i] = scratch[i - start].first;
+        weights[i] = std::move(scratch[i - start].second);
       }
     }
+  }
 
+  // Folds the published CSR, its delta and the COO load buffer into a new
+  // CSR. Existing edges come first so parallel edges keep their order.
+  void rebuild() {
+    StoreStats::Timer timer(stats.get(), StoreOp::CsrRebuild);
+    const Generation &gen = published();
+    const size_t total =
+        gen.csr_col_vals->size() + gen.delta_size + coo_src.size();
+    std::vector<VertexId> src;
+    std::vector<VertexId> dest;
+    std::vector<EdgeType> weights;
+    src.reserve(total);
+    dest.reserve(total);
+    weights.reserve(total);
+    const size_t csr_rows = gen.csr_row_offsets->size();
+    for (size_t row = 0; row + 1 < csr_rows; ++row) {
+      const RowParts parts = rowParts(gen, static_cast<VertexId>(row));
+      for (size_t i = parts.start; i < parts.end; ++i) {
+        const EdgeType *patched = patchAt(parts.delta, i - parts.start);
+        src.push_back(static_cast<VertexId>(row));
+        dest.push_back((*gen.csr_col_vals)[i]);
+        weights.push_back(patched ? *patched : (*gen.csr_weights)[i]);
+      }
+    }
+    for (const auto &[row, delta] : stagedRows(gen)) {
+      for (auto &edge : sortedDelta(rowParts(gen, row))) {
+        src.push_back(row);
+        dest.push_back(edge.dest);
+        weights.push_back(std::move(edge.weight));
+      }
+    }
+    src.insert(src.end(), coo_src.begin(), coo_src.end());
+    dest.insert(dest.end(), coo_dest.begin(), coo_dest.end());
+    std::move(coo_weights.begin(), coo_weights.end(),
+              std::back_inserter(weights));
     coo_src.clear();
     coo_dest.clear();
     coo_weights.clear();
     coo_src.shrink_to_fit();
     coo_dest.shrink_to_fit();
     coo_weights.shrink_to_fit();
+    publish(buildGeneration(*pool, numRows(), src, dest, weights));
   }
 
-  void incrementalUpdate() {
-    if (!is_built || coo_src.empty())
-      return;
-
-    const size_t num_vertices = vertex_order.size();
-    std::vector<size_t> new_edge_counts(num_vertices, 0);
+  bool deltaThresholdReached(const Generation &gen) const {
+    const size_t ratio_limit = static_cast<size_t>(
+        delta_ratio * static_cast<double>(gen.csr_col_vals->size()));
+    return gen.delta_size >= std::max(delta_min_edges, ratio_limit);
+  }
 
-    for (size_t i = 0; i < coo_src.size(); ++i) {
-      if (vertex_to_index.count(coo_src[i])) {
-        new_edge_counts[vertex_to_index[coo_src[i]]]++;
-      }
+  // Publishes `next`, merging its delta first if it has grown too large.
+  void publishStaged(GenerationPtr next) {
+    if (deltaThresholdReached(*next)) {
+      StoreStats::Timer timer(stats.get(), StoreOp::CsrRebuild);
+      next = merged(*next);
     }
+    publish(std::move(next));
+  }
 
+  void stageEdge(VertexId row, VertexId dest, const EdgeType &weight) {
+    const Generation &gen = published();
+    auto delta = appendedRow(rowParts(gen, row), {dest, weight});
+    publishStaged(withRowDeltas(gen, {{row, std::move(delta)}}, 1));
+  }
+
+  void mergeDelta() {
+    if (!published().delta)
+      return;
+    StoreStats::Timer timer(stats.get(), StoreOp::CsrRebuild);
+    publish(merged(published()));
+  }
+
+  GenerationPtr merged(const Generation &gen) const {
+    const auto &cols = *gen.csr_col_vals;
+    const auto &weights = *gen.csr_weights;
+    const auto staged = stagedRows(gen);
+    const size_t num_vertices = numRows();
     std::vector<size_t> new_row_offsets(num_vertices + 1, 0);
-    new_row_offsets[0] = csr_row_offsets[0];
-    for (size_t i = 0; i < num_vertices; ++i) {
-      new_row_offsets[i + 1] = new_row_offsets[i] +
-                               (csr_row_offsets[i + 1] - csr_row_offsets[i]) +
-                               new_edge_counts[i];
+    for (size_t row = 0; row < num_vertices; ++row) {
+      const auto [start, end] = csrRange(gen, static_cast<VertexId>(row));
+      new_row_offsets[row + 1] = end - start;
     }
+    for (const auto &[row, delta] : staged)
+      new_row_offsets[row + 1] += delta->size;
+    for (size_t row = 0; row < num_vertices; ++row)
+      new_row_offsets[row + 1] += new_row_offsets[row];
 
-    std::vector<VertexType> new_col_vals(new_row_offsets.back());
+    std::vector<VertexId> new_col_vals(new_row_offsets.back());
     std::vector<EdgeType> new_weights(new_row_offsets.back());
 
-    std::vector<size_t> insert_offsets = new_row_offsets;
+    size_t next_staged = 0;
     for (size_t row = 0; row < num_vertices; ++row) {
-      VertexType src = vertex_order[row];
-      size_t old_start = csr_row_offsets[row];
-      size_t old_end = csr_row_offsets[row + 1];
-      std::vector<std::pair<VertexType, EdgeType>> merged_neighbors;
-
-      for (size_t i = old_start; i < old_end; ++i) {
-        merged_neighbors.emplace_back(csr_col_vals[i], csr_weights[i]);
-      }
-
-      for (size_t i = 0; i < coo_src.size(); ++i) {
-        if (coo_src[i] == src && vertex_to_index.count(coo_dest[i])) {
-          merged_neighbors.emplace_back(coo_dest[i], coo_weights[i]);
+      size_t out = new_row_offsets[row];
+      RowParts parts;
+      std::tie(parts.start, parts.end) =
+          csrRange(gen, static_cast<VertexId>(row));
+      if (next_staged < staged.size() && staged[next_staged].first == row)
+        parts.delta = staged[next_staged++].second;
+      const std::vector<DeltaEdge> delta = sortedDelta(parts);
+      // Both runs are sorted by destination; existing CSR entries win ties so
+      // parallel edges keep their insertion order.
+      for (size_t i = parts.start, d = 0; i < parts.end || d < delta.size();
+           ++out) {
+        if (d < delta.size() && (i == parts.end || delta[d].dest < cols[i])) {
+          new_col_vals[out] = delta[d].dest;
+          new_weights[out] = delta[d].weight;
+          ++d;
+        } else {
+          const EdgeType *patched = patchAt(parts.delta, i - parts.start);
+          new_col_vals[out] = cols[i];
+          new_weights[out] = patched ? *patched : weights[i];
+          ++i;
         }
       }
-
-      std::sort(merged_neighbors.begin(), merged_neighbors.end(),
-                [](const auto &a, const auto &b) { return a.first < b.first; });
-
-      for (const auto &[dest, weight] : merged_neighbors) {
-        size_t pos = insert_offsets[row]++;
-        new_col_vals[pos] = dest;
-        new_weights[pos] = weight;
-      }
     }
+    return makeGeneration(std::move(new_row_offsets), std::move(new_col_vals),
+                          std::move(new_weights));
+  }
 
-    csr_row_offsets = std::move(new_row_offsets);
-    csr_col_vals = std::move(new_col_vals);
-    csr_weights = std::move(new_weights);
-
-    coo_src.clear();
-    coo_dest.clear();
-    coo_weights.clear();
-    coo_src.shrink_to_fit();
-    coo_dest.shrink_to_fit();
-    coo_weights.shrink_to_fit();
+  bool insertVertex(VertexId id) {
+    if (!vertex_present.set(id))
+      return false;
+    size_t rows = row_count.load(std::memory_order_relaxed);
+    while (rows <= id &&
+           !row_count.compare_exchange_weak(rows, size_t{id} + 1,
+                                            std::memory_order_release))
+      ;
+    return true;
   }
 
 public:
-  HybridCSR_COO() {
-    csr_row_offsets.reserve(1024);
-    csr_col_vals.reserve(4096);
-    csr_weights.reserve(4096);
-    coo_src.reserve(4096);
-    coo_dest.reserve(4096);
-    coo_weights.reserve(4096);
-    vertex_order.reserve(1024);
-    vertex_to_index.reserve(1024);
-  }
+  using typename PeakStorageInterface<VertexType, EdgeType>::EdgeBatch;
+
+  // CSR builds run on `thread_pool`, or on the global pool if none is given,
+  // and are timed into `store_stats` if one is given.
+  HybridCSR_COO(
+      std::shared_ptr<VertexDictionary<VertexType>> dictionary = nullptr,
+      std::shared_ptr<Concurrency::ThreadPool> thread_pool = nullptr,
+      std::shared_ptr<StoreStats> store_stats = nullptr)
+      : vertices(dictionary
+                     ? std::move(dictionary)
+                     : std::make_shared<VertexDictionary<VertexType>>()),
+        pool(thread_pool ? std::move(thread_pool)
+                         : Concurrency::ThreadPool::global()),
+        stats(std::move(store_stats)), owned(makeGeneration({}, {}, {})),
+        current(owned.get()) {}
+  HybridCSR_COO(const HybridCSR_COO &) = delete;
+  HybridCSR_COO &operator=(const HybridCSR_COO &) = delete;
 
   void populateFromAdjList(
       const std::unordered_map<VertexType,
                                std::vector<std::pair<VertexType, EdgeType>>,
                                VertexHasher<VertexType>> &adj_list) {
-    is_built = false;
+    vertex_present.reset();
+    row_count.store(0, std::memory_order_release);
     coo_src.clear();
     coo_dest.clear();
     coo_weights.clear();
-    vertex_order.clear();
-    vertex_to_index.clear();
+    publish(makeGeneration({}, {}, {}));
 
     for (const auto &[src, neighbors] : adj_list) {
-      if (!vertex_to_index.count(src)) {
-        vertex_to_index[src] = vertex_order.size();
-        vertex_order.push_back(src);
-      }
+      VertexId src_id = vertices->intern(src).first;
+      insertVertex(src_id);
       for (const auto &[dest, weight] : neighbors) {
-        if (!vertex_to_index.count(dest)) {
-          vertex_to_index[dest] = vertex_order.size();
-          vertex_order.push_back(dest);
-        }
-        coo_src.push_back(src);
-        coo_dest.push_back(dest);
+        VertexId dest_id = vertices->intern(dest).first;
+        insertVertex(dest_id);
+        coo_src.push_back(src_id);
+        coo_dest.push_back(dest_id);
         coo_weights.push_back(weight);
       }
     }
 
-    buildStructures();
+    rebuild();
+  }
+
+  // Folds the delta and any bulk-loaded edges into the CSR.
+  void flush() {
+    if (!coo_src.empty())
+      rebuild();
+    else
+      mergeDelta();
+  }
+
+  // Replaces the contents with a CSR that was built elsewhere, e.g. by
+  // IngestPipeline::build(). `row_offsets` covers rows [0, n) and every
+  // row must be sorted by destination; `present` lists the ids to mark as
+  // vertices of this engine.
+  void adopt(const std::vector<VertexId> &present,
+             std::vector<size_t> row_offsets, std::vector<VertexId> col_vals,
+             std::vector<EdgeType> weights) {
+    vertex_present.reset();
+    row_count.store(0, std::memory_order_release);
+    coo_src.clear();
+    coo_dest.clear();
+    coo_weights.clear();
+    for (VertexId id : present)
+      insertVertex(id);
+    publish(makeGeneration(std::move(row_offsets), std::move(col_vals),
+                           std::move(weights)));
+  }
+
+  // Folds pending edges into the CSR and shares its arrays. Rows of
+  // vertices added since the last build are padded in as empty rows, and
+  // ids without a vertex are marked absent.
+  CsrSnapshot<EdgeType> snapshot() {
+    flush();
+    const Generation &gen = published();
+    CsrSnapshot<EdgeType> out;
+    const size_t rows = numRows();
+    if (gen.csr_row_offsets->size() == rows + 1) {
+      out.row_offsets = gen.csr_row_offsets;
+    } else {
+      std::vector<size_t> offsets = *gen.csr_row_offsets;
+      offsets.resize(rows + 1, offsets.empty() ? 0 : offsets.back());
+      out.row_offsets =
+          std::make_shared<const std::vector<size_t>>(std::move(offsets));
+    }
+    out.col_vals = gen.csr_col_vals;
+    out.weights = gen.csr_weights;
+    std::vector<std::uint8_t> present(rows, 0);
+    bool sparse = false;
+    for (size_t v = 0; v < rows; ++v) {
+      present[v] = vertex_present.test(v);
+      sparse |= !present[v];
+    }
+    if (sparse)
+      out.present =
+          std::make_shared<const std::vector<std::uint8_t>>(std::move(present));
+    return out;
+  }
+
+  // The delta is merged once it holds at least max(min_edges,
+  // ratio * csr_edges) entries.
+  void setDeltaThreshold(size_t min_edges, double ratio) {
+    delta_min_edges = min_edges;
+    delta_ratio = ratio;
+    if (deltaThresholdReached(published()))
+      mergeDelta();
+  }
+
+  // Edges not yet folded into the CSR.
+  size_t pendingEdges() const {
+    auto guard = epochs.pin();
+    return published().staged_edges + coo_src.size();
+  }
+
+  // Id-level access used by storage migration and graph iteration; callers
+  // pass ids obtained from the shared dictionary.
+  size_t impl_rowCount() const override { return numRows(); }
+  // Staged rows are counted by their entries; trie nodes are left out.
+  size_t impl_bytesAllocated() const override {
+    auto guard = epochs.pin();
+    const Generation &gen = published();
+    return gen.csr_row_offsets->capacity() * sizeof(size_t) +
+           gen.csr_col_vals->capacity() * sizeof(VertexId) +
+           gen.csr_weights->capacity() * sizeof(EdgeType) +
+           gen.delta_size * sizeof(DeltaEdge) +
+           coo_src.capacity() * sizeof(VertexId) +
+           coo_dest.capacity() * sizeof(VertexId) +
+           coo_weights.capacity() * sizeof(EdgeType);
+  }
+  bool impl_hasRow(VertexId id) const override {
+    return vertex_present.test(id);
+  }
+  // The view covers the CSR row followed by the row's staged delta edges,
+  // with updated weights patched over both, and holds a reference to the
+  // generation they belong to.
+  NeighborView<VertexType, EdgeType>
+  impl_neighborsById(VertexId row) override {
+    auto guard = epochs.pin();
+    const Generation &gen = published();
+    const RowParts parts = rowParts(gen, row);
+    const size_t csr_size = parts.end - parts.start;
+    const RowDelta *delta = parts.delta;
+    static const std::shared_ptr<const Patches> none;
+    const auto &recent = delta ? delta->recent : none;
+    const auto &older = delta ? delta->patches : none;
+    return {vertices.get(),
+            NeighborRun<EdgeType>::contiguous(
+                gen.csr_col_vals->data() + parts.start,
+                gen.csr_weights->data() + parts.start, csr_size)
+                .withPatches(patchRange(recent, 0, csr_size),
+                             patchRange(older, 0, csr_size), 0),
+            NeighborRun<EdgeType>::strided(delta ? delta->edges() : nullptr,
+                                           delta ? delta->size : 0,
+                                           &DeltaEdge::dest, &DeltaEdge::weight)
+                .withPatches(patchRange(recent, csr_size),
+                             patchRange(older, csr_size), csr_size),
+            gen.shared_from_this()};
+  }
+  template <typename Fn>
+  void impl_forEachNeighbor(VertexId row, Fn &&fn) const {
+    auto guard = epochs.pin();
+    forEachInRow(published(), row, fn);
+  }
+  bool impl_addVertexById(VertexId id) { return insertVertex(id); }
+  // Bulk-load path used by storage migration: edges go to the COO buffer
+  // and only become visible once flush() folds them into the CSR.
+  void impl_addEdgeById(VertexId src, VertexId dest, const EdgeType &weight) {
+    coo_src.push_back(src);
+    coo_dest.push_back(dest);
+    coo_weights.push_back(weight);
+  }
+  // A weight update is recorded as a patch on the row's delta, so it copies
+  // only the row's patch list.
+  EdgeInsertResult impl_insertEdgeById(VertexId src, VertexId dest,
+                                       const EdgeType &weight,
+                                       EdgeInsertMode mode) {
+    const Generation &gen = published();
+    const RowParts parts = rowParts(gen, src);
+    const size_t csr_pos = findInCSR(gen, parts, dest);
+    const size_t delta_pos = csr_pos == npos ? findInDelta(parts, dest) : npos;
+    const bool exists = csr_pos != npos || delta_pos != npos;
+    if (!exists || mode == EdgeInsertMode::AllowParallel) {
+      stageEdge(src, dest, weight);
+      return exists ? EdgeInsertResult::InsertedParallel
+                    : EdgeInsertResult::Inserted;
+    }
+    if (mode == EdgeInsertMode::InsertIfAbsent)
+      return EdgeInsertResult::Existing;
+    const size_t pos = csr_pos != npos ? csr_pos - parts.start
+                                       : parts.end - parts.start + delta_pos;
+    auto delta = patchedRow(parts, pos, weight);
+    publishStaged(withRowDeltas(gen, {{src, std::move(delta)}}, 0));
+    return EdgeInsertResult::Updated;
   }
 
   void exc() const {
     std::cout << "HybridCSR_COO CSR:\n";
-    for (size_t i = 0; i < vertex_order.size(); ++i) {
-      std::cout << vertex_order[i] << " -> ";
-      for (size_t j = csr_row_offsets[i]; j < csr_row_offsets[i + 1]; ++j) {
-        std::cout << "(" << csr_col_vals[j] << ", " << csr_weights[j] << ") ";
-      }
+    auto guard = epochs.pin();
+    const Generation &gen = published();
+    for (size_t i = 0; i < numRows(); ++i) {
+      if (!vertex_present.test(i))
+        continue;
+      std::cout << vertices->vertex(i) << " -> ";
+      forEachInRow(gen, static_cast<VertexId>(i),
+                   [&](VertexId dest, const EdgeType &weight) {
+                     std::cout << "(" << vertices->vertex(dest) << ", "
+                               << weight << ") ";
+                   });
       std::cout << "\n";
     }
+    if (gen.staged_edges) {
+      std::cout << "(" << gen.staged_edges << " staged edges pending merge)\n";
+    }
   }
 
   const PeakStatus impl_addVertex(const VertexType &vtx) override {
-    if (vertex_to_index.count(vtx)) {
+    if (!insertVertex(vertices->intern(vtx).first)) {
       return PeakStatus::AlreadyExists();
     }
-    size_t new_idx = vertex_order.size();
-    vertex_to_index[vtx] = new_idx;
-    vertex_order.push_back(vtx);
-    if (is_built) {
-      csr_row_offsets.push_back(csr_row_offsets.back());
-    }
     return PeakStatus::OK();
   }
 
   const PeakStatus impl_addEdge(const VertexType &src, const VertexType &dest,
                                 const EdgeType &weight) override {
-    if (!vertex_to_index.count(src) || !vertex_to_index.count(dest)) {
+    VertexId src_id = rowOf(src);
+    VertexId dest_id = rowOf(dest);
+    if (src_id == INVALID_VERTEX_ID || dest_id == INVALID_VERTEX_ID) {
       return PeakStatus::VertexNotFound();
     }
-    coo_src.push_back(src);
-    coo_dest.push_back(dest);
-    coo_weights.push_back(weight);
-    if (is_built) {
-      incrementalUpdate();
-    }
+    stageEdge(src_id, dest_id, weight);
     return PeakStatus::OK();
   }
 
@@ -228,6 +1006,91 @@ public:
     return impl_addEdge(src, dest, EdgeType{});
   }
 
+  const std::pair<EdgeInsertResult, PeakStatus>
+  impl_insertEdge(const VertexType &src, const VertexType &dest,
+                  const EdgeType &weight, EdgeInsertMode mode) override {
+    VertexId src_id = rowOf(src);
+    VertexId dest_id = rowOf(dest);
+    if (src_id == INVALID_VERTEX_ID || dest_id == INVALID_VERTEX_ID)
+      return {EdgeInsertResult::Existing, PeakStatus::VertexNotFound()};
+    return {impl_insertEdgeById(src_id, dest_id, weight, mode),
+            PeakStatus::OK()};
+  }
+
+  // Into an empty engine the batch goes straight through the counting-sort
+  // construction. Otherwise it is sorted once and merged row by row into the
+  // row deltas.
+  const std::pair<size_t, PeakStatus>
+  impl_addEdges(const EdgeBatch &edges, size_t *parallel = nullptr) override {
+    std::vector<std::pair<VertexId, VertexId>> ids;
+    ids.reserve(edges.size());
+    for (const auto &[src, dest, weight] : edges) {
+      VertexId src_id = rowOf(src);
+      VertexId dest_id = rowOf(dest);
+      if (src_id == INVALID_VERTEX_ID || dest_id == INVALID_VERTEX_ID)
+        return {0, PeakStatus::VertexNotFound()};
+      ids.emplace_back(src_id, dest_id);
+    }
+    const Generation &gen = published();
+    if (gen.csr_col_vals->empty() && !gen.delta) {
+      coo_src.reserve(coo_src.size() + edges.size());
+      coo_dest.reserve(coo_dest.size() + edges.size());
+      coo_weights.reserve(coo_weights.size() + edges.size());
+      for (size_t i = 0; i < edges.size(); ++i) {
+        coo_src.push_back(ids[i].first);
+        coo_dest.push_back(ids[i].second);
+        coo_weights.push_back(std::get<2>(edges[i]));
+      }
+      rebuild();
+      if (parallel) {
+        // The engine held no edges, so every repeat in the new CSR rows
+        // came from the batch.
+        const Generation &built = published();
+        const auto &offsets = *built.csr_row_offsets;
+        const auto &cols = *built.csr_col_vals;
+        for (size_t row = 0; row + 1 < offsets.size(); ++row) {
+          for (size_t i = offsets[row] + 1; i < offsets[row + 1]; ++i)
+            *parallel += cols[i] == cols[i - 1];
+        }
+      }
+      return {edges.size(), PeakStatus::OK()};
+    }
+    std::vector<size_t> order(edges.size());
+    for (size_t i = 0; i < order.size(); ++i)
+      order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&ids](size_t a, size_t b) {
+      return ids[a] < ids[b];
+    });
+    StagedRows rows;
+    for (size_t first = 0; first < order.size();) {
+      const VertexId row = ids[order[first]].first;
+      size_t last = first;
+      std::vector<DeltaEdge> added;
+      for (; last < order.size() && ids[order[last]].first == row; ++last) {
+        const size_t i = order[last];
+        added.push_back({ids[i].second, std::get<2>(edges[i])});
+      }
+      const RowParts parts = rowParts(gen, row);
+      if (parallel) {
+        for (size_t i = 0; i < added.size(); ++i)
+          *parallel += (i > 0 && added[i].dest == added[i - 1].dest) ||
+                       findInCSR(gen, parts, added[i].dest) != npos ||
+                       findInDelta(parts, added[i].dest) != npos;
+      }
+      const std::vector<DeltaEdge> staged = sortedDelta(parts);
+      std::vector<DeltaEdge> row_edges;
+      row_edges.reserve(staged.size() + added.size());
+      // Stable: staged edges precede new parallel edges.
+      std::merge(staged.begin(), staged.end(), added.begin(), added.end(),
+                 std::back_inserter(row_edges), deltaLess);
+      rows.emplace_back(
+          row, sortedRowDelta(std::move(row_edges), csrPatches(parts)));
+      first = last;
+    }
+    publishStaged(withRowDeltas(gen, rows, edges.size()));
+    return {edges.size(), PeakStatus::OK()};
+  }
+
   bool impl_doesEdgeExist(const VertexType &src, const VertexType &dest,
                           const EdgeType &weight) override {
     auto edge = impl_getEdge(src, dest);
@@ -241,25 +1104,38 @@ public:
 
   const std::pair<EdgeType, PeakStatus>
   impl_getEdge(const VertexType &src, const VertexType &dest) override {
-    if (!is_built) {
-      buildStructures();
-    }
-    if (!vertex_to_index.count(src) || !vertex_to_index.count(dest)) {
+    VertexId row = rowOf(src);
+    VertexId dest_id = rowOf(dest);
+    if (row == INVALID_VERTEX_ID || dest_id == INVALID_VERTEX_ID) {
       return {EdgeType{}, PeakStatus::VertexNotFound()};
     }
-    size_t row = vertex_to_index.at(src);
-    size_t start = csr_row_offsets[row];
-    size_t end = csr_row_offsets[row + 1];
-
-    auto it = std::lower_bound(csr_col_vals.begin() + start,
-                               csr_col_vals.begin() + end, dest);
-    if (it != csr_col_vals.begin() + end && *it == dest) {
-      size_t idx = std::distance(csr_col_vals.begin(), it);
-      return {csr_weights[idx], PeakStatus::OK()};
+    auto guard = epochs.pin();
+    if (const EdgeType *weight = findEdge(published(), row, dest_id)) {
+      return {*weight, PeakStatus::OK()};
     }
     return {EdgeType{}, PeakStatus::EdgeNotFound()};
   }
+
+  const std::pair<std::vector<std::pair<VertexType, EdgeType>>, PeakStatus>
+  impl_getNeighbors(const VertexType &vertex) const override {
+    VertexId row = rowOf(vertex);
+    if (row == INVALID_VERTEX_ID) {
+      return {{}, PeakStatus::VertexNotFound()};
+    }
+    std::vector<std::pair<VertexType, EdgeType>> neighbors;
+    impl_forEachNeighbor(row, [&](VertexId dest, const EdgeType &weight) {
+      neighbors.emplace_back(vertices->vertex(dest), weight);
+    });
+    return {std::move(neighbors), PeakStatus::OK()};
+  }
+  std::pair<NeighborView<VertexType, EdgeType>, PeakStatus>
+  impl_neighbors(const VertexType &vertex) override {
+    VertexId row = rowOf(vertex);
+    if (row == INVALID_VERTEX_ID)
+      return {{}, PeakStatus::VertexNotFound()};
+    return {impl_neighborsById(row), PeakStatus::OK()};
+  }
 };
 
 } // namespace PeakStore
-} // namespace CinderPeak
\ No newline at end of file
+} // namespace CinderPeak
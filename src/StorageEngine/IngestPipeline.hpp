@@ -0,0 +1,386 @@
+#pragma once
+#include "Concurrency/ThreadPool.hpp"
+#include "StorageEngine/CsrSnapshot.hpp"
+#include "StorageEngine/Utils.hpp"
+#include "StorageEngine/VertexDictionary.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+namespace CinderPeak {
+namespace PeakStore {
+
+// Bulk edge ingest fed by any number of producer threads. push() routes each
+// edge to a partition by the hash of its source vertex, so every source row
+// is owned by exactly one partition. build() then works partition by
+// partition on a thread pool: it interns the vertices, sorts each
+// partition's edges into a CSR slice and stitches the slices into one CSR
+// without a global sort. PeakStore::commitIngest merges the result into the
+// current graph with merge(), so existing edges are never re-partitioned.
+template <typename VertexType, typename EdgeType> class IngestPipeline {
+public:
+  using Edge = std::tuple<VertexType, VertexType, EdgeType>;
+
+  // A CSR over every vertex the pipeline saw, ready for
+  // HybridCSR_COO::adopt(). Rows are sorted by destination.
+  struct Stitched {
+    std::vector<VertexId> vertices;
+    std::vector<size_t> row_offsets;
+    std::vector<VertexId> col_vals;
+    std::vector<EdgeType> weights;
+    // Self loops, and edges repeating the (src, dest) of an earlier one.
+    size_t self_loops = 0;
+    size_t parallel_edges = 0;
+  };
+
+  explicit IngestPipeline(size_t partitions) {
+    for (size_t p = 0; p < std::max<size_t>(1, partitions); ++p)
+      parts.push_back(std::make_unique<Partition>());
+  }
+
+  size_t partitionCount() const { return parts.size(); }
+  size_t size() const { return pushed.load(std::memory_order_relaxed); }
+
+  // Thread-safe. Accepts (src, dest) pairs/tuples as well as
+  // (src, dest, weight) tuples. The batch is bucketed locally first, so a
+  // producer takes each partition lock at most once per batch.
+  template <typename Range> void push(const Range &edges) {
+    std::vector<std::vector<Edge>> buckets(parts.size());
+    size_t count = 0;
+    for (const auto &edge : edges) {
+      Edge e = toEdge(edge);
+      buckets[partitionOf(std::get<0>(e))].push_back(std::move(e));
+      ++count;
+    }
+    for (size_t p = 0; p < parts.size(); ++p) {
+      if (buckets[p].empty())
+        continue;
+      std::lock_guard<std::mutex> lock(parts[p]->mutex);
+      auto &target = parts[p]->edges;
+      std::move(buckets[p].begin(), buckets[p].end(),
+                std::back_inserter(target));
+    }
+    pushed.fetch_add(count, std::memory_order_relaxed);
+  }
+  // Thread-safe. Adds vertices that may have no edges.
+  template <typename Range> void pushVertices(const Range &vertices) {
+    std::vector<std::vector<VertexType>> buckets(parts.size());
+    for (const auto &v : vertices)
+      buckets[partitionOf(v)].push_back(v);
+    for (size_t p = 0; p < parts.size(); ++p) {
+      if (buckets[p].empty())
+        continue;
+      std::lock_guard<std::mutex> lock(parts[p]->mutex);
+      auto &target = parts[p]->vertices;
+      target.insert(target.end(), buckets[p].begin(), buckets[p].end());
+    }
+  }
+  // Raw contents of partition `p`, for stores whose engine cannot adopt a
+  // prebuilt CSR and insert partition by partition instead.
+  const std::vector<Edge> &edgesOf(size_t p) const { return parts[p]->edges; }
+  const std::vector<VertexType> &verticesOf(size_t p) const {
+    return parts[p]->vertices;
+  }
+  void clear() {
+    for (auto &part : parts) {
+      part->edges = {};
+      part->vertices = {};
+    }
+    pushed.store(0, std::memory_order_relaxed);
+  }
+
+  // Consumes the pushed edges. Self loops are dropped unless `self_loops`,
+  // and repeated (src, dest) pairs keep only their first occurrence unless
+  // `parallel_edges`. Every step runs one partition per task; a
+  // single-threaded dictionary only interns the vertices it has never seen
+  // serially, after the partitions have looked up the rest.
+  Stitched build(Concurrency::ThreadPool &pool,
+                 VertexDictionary<VertexType> &dictionary, bool self_loops,
+                 bool parallel_edges) {
+    const size_t count = parts.size();
+    auto each_partition = [&](auto &&fn) {
+      pool.parallel_for(
+          0, count,
+          [&](size_t lo, size_t hi) {
+            for (size_t p = lo; p < hi; ++p)
+              fn(p);
+          },
+          1);
+    };
+
+    // Each distinct vertex is handed to the partition its own hash picks,
+    // so exactly one task interns it.
+    each_partition([&](size_t p) {
+      Partition &part = *parts[p];
+      if (!self_loops) {
+        part.edges.erase(std::remove_if(part.edges.begin(), part.edges.end(),
+                                        [](const Edge &e) {
+                                          return std::get<0>(e) ==
+                                                 std::get<1>(e);
+                                        }),
+                         part.edges.end());
+      }
+      std::unordered_set<VertexType, VertexHasher<VertexType>> seen(
+          part.vertices.begin(), part.vertices.end());
+      for (const auto &[src, dest, weight] : part.edges) {
+        seen.insert(src);
+        seen.insert(dest);
+      }
+      part.vertices = {};
+      part.outgoing.assign(count, {});
+      for (const auto &v : seen)
+        part.outgoing[partitionOf(v)].push_back(v);
+    });
+    each_partition([&](size_t p) {
+      Partition &part = *parts[p];
+      std::unordered_set<VertexType, VertexHasher<VertexType>> owned;
+      for (auto &other : parts) {
+        owned.insert(other->outgoing[p].begin(), other->outgoing[p].end());
+        other->outgoing[p] = {};
+      }
+      for (const auto &v : owned) {
+        if (dictionary.isConcurrent()) {
+          part.ids.push_back(dictionary.intern(v).first);
+        } else if (const VertexId id = dictionary.find(v);
+                   id != INVALID_VERTEX_ID) {
+          part.ids.push_back(id);
+        } else {
+          part.vertices.push_back(v);
+        }
+      }
+    });
+    size_t unseen = 0;
+    for (auto &part : parts) {
+      unseen += part->vertices.size();
+      part->outgoing = {};
+    }
+    if (unseen) {
+      dictionary.reserve(dictionary.size() + unseen);
+      for (auto &part : parts) {
+        for (const auto &v : part->vertices)
+          part->ids.push_back(dictionary.intern(v).first);
+        part->vertices = {};
+      }
+    }
+
+    Stitched out;
+    for (auto &part : parts) {
+      out.vertices.insert(out.vertices.end(), part->ids.begin(),
+                          part->ids.end());
+      part->ids = {};
+    }
+    const size_t num_rows =
+        out.vertices.empty()
+            ? 0
+            : size_t{*std::max_element(out.vertices.begin(),
+                                       out.vertices.end())} +
+                  1;
+
+    // Each partition owns its source rows outright, so the slices can be
+    // sorted and counted without coordination.
+    each_partition([&](size_t p) {
+      Partition &part = *parts[p];
+      part.slice.reserve(part.edges.size());
+      for (auto &[src, dest, weight] : part.edges)
+        part.slice.push_back(
+            {dictionary.find(src), dictionary.find(dest), std::move(weight)});
+      part.edges.clear();
+      part.edges.shrink_to_fit();
+      std::stable_sort(part.slice.begin(), part.slice.end(),
+                       [](const IdEdge &a, const IdEdge &b) {
+                         return std::tie(a.src, a.dest) <
+                                std::tie(b.src, b.dest);
+                       });
+      if (!parallel_edges) {
+        part.slice.erase(std::unique(part.slice.begin(), part.slice.end(),
+                                     [](const IdEdge &a, const IdEdge &b) {
+                                       return a.src == b.src &&
+                                              a.dest == b.dest;
+                                     }),
+                         part.slice.end());
+      }
+    });
+
+    out.row_offsets.assign(num_rows + 1, 0);
+    each_partition([&](size_t p) {
+      for (const auto &edge : parts[p]->slice)
+        out.row_offsets[edge.src + 1]++;
+    });
+    for (size_t row = 0; row < num_rows; ++row)
+      out.row_offsets[row + 1] += out.row_offsets[row];
+
+    const size_t num_edges = out.row_offsets.back();
+    out.col_vals.resize(num_edges);
+    out.weights.resize(num_edges);
+    each_partition([&](size_t p) {
+      Partition &part = *parts[p];
+      part.self_loops = part.parallel_edges = 0;
+      size_t pos = 0;
+      for (size_t i = 0; i < part.slice.size(); ++i) {
+        const IdEdge &edge = part.slice[i];
+        if (i == 0 || edge.src != part.slice[i - 1].src) {
+          pos = out.row_offsets[edge.src];
+        } else if (edge.dest == part.slice[i - 1].dest) {
+          ++part.parallel_edges;
+        }
+        part.self_loops += edge.src == edge.dest;
+        out.col_vals[pos] = edge.dest;
+        out.weights[pos] = std::move(part.slice[i].weight);
+        ++pos;
+      }
+      part.slice.clear();
+      part.slice.shrink_to_fit();
+    });
+    for (auto &part : parts) {
+      out.self_loops += part->self_loops;
+      out.parallel_edges += part->parallel_edges;
+    }
+    pushed.store(0, std::memory_order_relaxed);
+    return out;
+  }
+
+  // Merges a built batch into the graph `base` in one pass per row. Each
+  // row keeps its existing edges ahead of the batch's, and unless
+  // `parallel_edges` a batch edge whose (src, dest) the row already holds
+  // is dropped. The result lists every vertex of either, and its counts
+  // cover only the edges taken from the batch.
+  static Stitched merge(Concurrency::ThreadPool &pool,
+                        const CsrSnapshot<EdgeType> &base, Stitched batch,
+                        bool parallel_edges) {
+    const size_t base_rows = base.numVertices();
+    const size_t batch_rows = batch.row_offsets.size() - 1;
+    const size_t n = std::max(base_rows, batch_rows);
+    const size_t *base_offsets = base.offsets();
+    const VertexId *base_cols = base.cols();
+    const bool base_weighted = !base.weights->empty();
+    auto base_row = [&](size_t v) {
+      return v < base_rows ? std::make_pair(base_offsets[v],
+                                            base_offsets[v + 1])
+                           : std::make_pair(size_t{0}, size_t{0});
+    };
+    auto batch_row = [&](size_t v) {
+      return v < batch_rows ? std::make_pair(batch.row_offsets[v],
+                                             batch.row_offsets[v + 1])
+                            : std::make_pair(size_t{0}, size_t{0});
+    };
+    auto by_row = [&](size_t v) {
+      return base_row(v).second - base_row(v).first +
+             batch_row(v).second - batch_row(v).first + 1;
+    };
+
+    Stitched out;
+    out.row_offsets.assign(n + 1, 0);
+    std::atomic<size_t> dropped_loops{0}, joined{0};
+    pool.parallel_for_weighted(0, n, by_row, [&](size_t lo, size_t hi) {
+      size_t loops = 0, groups = 0;
+      for (size_t v = lo; v < hi; ++v) {
+        const auto [base_lo, base_hi] = base_row(v);
+        const auto [batch_lo, batch_hi] = batch_row(v);
+        size_t length = base_hi - base_lo;
+        size_t i = base_lo;
+        for (size_t j = batch_lo; j < batch_hi; ++j) {
+          const VertexId dest = batch.col_vals[j];
+          while (i < base_hi && base_cols[i] < dest)
+            ++i;
+          if (i == base_hi || base_cols[i] != dest) {
+            ++length;
+          } else if (parallel_edges) {
+            ++length;
+            groups += j == batch_lo || batch.col_vals[j - 1] != dest;
+          } else {
+            loops += dest == v;
+          }
+        }
+        out.row_offsets[v + 1] = length;
+      }
+      dropped_loops.fetch_add(loops, std::memory_order_relaxed);
+      joined.fetch_add(groups, std::memory_order_relaxed);
+    });
+    for (size_t v = 0; v < n; ++v)
+      out.row_offsets[v + 1] += out.row_offsets[v];
+
+    out.col_vals.resize(out.row_offsets[n]);
+    out.weights.resize(out.row_offsets[n]);
+    pool.parallel_for_weighted(0, n, by_row, [&](size_t lo, size_t hi) {
+      for (size_t v = lo; v < hi; ++v) {
+        auto [i, base_hi] = base_row(v);
+        auto [j, batch_hi] = batch_row(v);
+        const size_t start = out.row_offsets[v];
+        size_t pos = start;
+        while (i < base_hi || j < batch_hi) {
+          if (j == batch_hi ||
+              (i < base_hi && base_cols[i] <= batch.col_vals[j])) {
+            out.col_vals[pos] = base_cols[i];
+            out.weights[pos] =
+                base_weighted ? (*base.weights)[i] : EdgeType();
+            ++pos, ++i;
+            continue;
+          }
+          const VertexId dest = batch.col_vals[j];
+          if (parallel_edges || pos == start ||
+              out.col_vals[pos - 1] != dest) {
+            out.col_vals[pos] = dest;
+            out.weights[pos] = std::move(batch.weights[j]);
+            ++pos;
+          }
+          ++j;
+        }
+      }
+    });
+
+    std::vector<std::uint8_t> present(n, 0);
+    for (size_t v = 0; v < base_rows; ++v)
+      present[v] = base.isVertex(static_cast<VertexId>(v));
+    for (VertexId id : batch.vertices)
+      present[id] = 1;
+    for (size_t v = 0; v < n; ++v) {
+      if (present[v])
+        out.vertices.push_back(static_cast<VertexId>(v));
+    }
+    out.self_loops = batch.self_loops - dropped_loops.load();
+    out.parallel_edges = batch.parallel_edges + joined.load();
+    return out;
+  }
+
+private:
+  struct IdEdge {
+    VertexId src;
+    VertexId dest;
+    EdgeType weight;
+  };
+  struct Partition {
+    std::mutex mutex;
+    std::vector<Edge> edges;
+    std::vector<VertexType> vertices;
+    // outgoing[q] holds this partition's vertices that partition q interns.
+    std::vector<std::vector<VertexType>> outgoing;
+    std::vector<VertexId> ids;
+    std::vector<IdEdge> slice;
+    size_t self_loops = 0;
+    size_t parallel_edges = 0;
+  };
+
+  std::vector<std::unique_ptr<Partition>> parts;
+  std::atomic<size_t> pushed{0};
+
+  size_t partitionOf(const VertexType &v) const {
+    const std::uint64_t mixed =
+        static_cast<std::uint64_t>(VertexHasher<VertexType>()(v)) *
+        0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>((mixed >> 32) % parts.size());
+  }
+  template <typename E> static Edge toEdge(const E &edge) {
+    if constexpr (std::tuple_size_v<E> >= 3) {
+      return {std::get<0>(edge), std::get<1>(edge), std::get<2>(edge)};
+    } else {
+      return {std::get<0>(edge), std::get<1>(edge), EdgeType()};
+    }
+  }
+};
+
+} // namespace PeakStore
+} // namespace CinderPeak
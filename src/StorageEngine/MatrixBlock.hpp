@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+namespace CinderPeak {
+namespace PeakStore {
+
+inline unsigned countTrailingZeros(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(word));
+#elif defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward64(&index, word);
+  return static_cast<unsigned>(index);
+#else
+  unsigned index = 0;
+  while (!(word & 1)) {
+    word >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+inline unsigned countSetBits(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_popcountll(word));
+#else
+  unsigned count = 0;
+  for (; word; word &= word - 1)
+    ++count;
+  return count;
+#endif
+}
+
+constexpr size_t MATRIX_BLOCK_DIM = 64;
+
+// One MATRIX_BLOCK_DIM x MATRIX_BLOCK_DIM tile of an AdjacencyMatrix. Holds a
+// packed bitset of the edges it contains and, for weighted graphs, a
+// row-major weight array.
+template <typename EdgeType> class MatrixBlock {
+public:
+  static constexpr size_t DIM = MATRIX_BLOCK_DIM;
+  static constexpr size_t CELLS = DIM * DIM;
+
+  // bits[r] has bit c set when the edge (r, c) of this block exists.
+  std::array<std::uint64_t, DIM> bits{};
+  // Uninitialized storage; slot r * DIM + c is constructed only while the
+  // matching bit is set.
+  EdgeType *weights = nullptr;
+
+  explicit MatrixBlock(bool weighted) {
+    if (weighted)
+      weights = std::allocator<EdgeType>().allocate(CELLS);
+  }
+  MatrixBlock(const MatrixBlock &) = delete;
+  MatrixBlock &operator=(const MatrixBlock &) = delete;
+  ~MatrixBlock() {
+    if (!weights)
+      return;
+    if constexpr (!std::is_trivially_destructible_v<EdgeType>) {
+      for (size_t r = 0; r < DIM; ++r) {
+        for (std::uint64_t word = bits[r]; word; word &= word - 1)
+          weights[r * DIM + countTrailingZeros(word)].~EdgeType();
+      }
+    }
+    std::allocator<EdgeType>().deallocate(weights, CELLS);
+  }
+
+  size_t bytesAllocated() const {
+    return sizeof(*this) + (weights ? CELLS * sizeof(EdgeType) : 0);
+  }
+  bool test(size_t r, size_t c) const { return (bits[r] >> c) & 1; }
+  // Returns true when the edge already existed.
+  // The weight is constructed before its bit is set, so a throwing
+  // constructor leaves the block unchanged.
+  bool set(size_t r, size_t c, const EdgeType &weight) {
+    const bool exists = test(r, c);
+    if (weights) {
+      EdgeType *slot = weights + r * DIM + c;
+      if (exists)
+        *slot = weight;
+      else
+        ::new (static_cast<void *>(slot)) EdgeType(weight);
+    }
+    bits[r] |= std::uint64_t{1} << c;
+    return exists;
+  }
+  const EdgeType *weight(size_t r, size_t c) const {
+    return weights ? weights + r * DIM + c : nullptr;
+  }
+};
+
+} // namespace PeakStore
+} // namespace CinderPeak
@@ -0,0 +1,104 @@
+#pragma once
+#include "StorageEngine/VertexDictionary.hpp"
+#include <cstdint>
+#include <vector>
+namespace CinderPeak {
+namespace PeakStore {
+
+// Neighbor storage for one AdjacencyList row. Ids and weights live in
+// separate contiguous arrays in insertion order. Low-degree rows are searched
+// with a linear scan over the id array. Once a row reaches INDEX_THRESHOLD
+// neighbors it also maintains an embedded open-addressing index from neighbor
+// id to the position of its first occurrence, so lookups on hub vertices stay
+// O(1) without reordering the neighbors.
+template <typename EdgeType> class NeighborList {
+public:
+  static constexpr size_t INDEX_THRESHOLD = 32;
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+  std::vector<VertexId> ids;
+  std::vector<EdgeType> weights;
+  // Each slot holds position + 1 of a neighbor, or 0 when empty. The
+  // capacity is a power of two kept at least twice the row size.
+  std::vector<std::uint32_t> index;
+
+  size_t slotFor(VertexId id) const {
+    // Fibonacci hashing spreads consecutive ids across the table.
+    const std::uint64_t h =
+        static_cast<std::uint64_t>(id) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(h >> 32) & (index.size() - 1);
+  }
+
+  void indexInsert(size_t pos) {
+    size_t slot = slotFor(ids[pos]);
+    while (index[slot] != 0) {
+      if (ids[index[slot] - 1] == ids[pos])
+        return; // keep the first occurrence of a parallel edge
+      slot = (slot + 1) & (index.size() - 1);
+    }
+    index[slot] = static_cast<std::uint32_t>(pos + 1);
+  }
+
+  void rebuildIndex(size_t capacity) {
+    index.assign(capacity, 0);
+    for (size_t pos = 0; pos < ids.size(); ++pos)
+      indexInsert(pos);
+  }
+
+public:
+  size_t size() const { return ids.size(); }
+  size_t bytesAllocated() const {
+    return ids.capacity() * sizeof(VertexId) +
+           weights.capacity() * sizeof(EdgeType) +
+           index.capacity() * sizeof(std::uint32_t);
+  }
+  bool empty() const { return ids.empty(); }
+  bool indexed() const { return !index.empty(); }
+  const VertexId *idData() const { return ids.data(); }
+  const EdgeType *weightData() const { return weights.data(); }
+  VertexId idAt(size_t pos) const { return ids[pos]; }
+  const EdgeType &weightAt(size_t pos) const { return weights[pos]; }
+  EdgeType &weightAt(size_t pos) { return weights[pos]; }
+
+  void reserve(size_t n) {
+    ids.reserve(n);
+    weights.reserve(n);
+  }
+
+  void push_back(VertexId id, const EdgeType &weight) {
+    ids.push_back(id);
+    weights.push_back(weight);
+    if (indexed()) {
+      if (ids.size() * 2 > index.size())
+        rebuildIndex(index.size() * 2);
+      else
+        indexInsert(ids.size() - 1);
+    } else if (ids.size() >= INDEX_THRESHOLD) {
+      size_t capacity = 1;
+      while (capacity < ids.size() * 4)
+        capacity <<= 1;
+      rebuildIndex(capacity);
+    }
+  }
+
+  // Position of the first edge to `id`, or npos.
+  size_t find(VertexId id) const {
+    if (!indexed()) {
+      for (size_t pos = 0; pos < ids.size(); ++pos) {
+        if (ids[pos] == id)
+          return pos;
+      }
+      return npos;
+    }
+    for (size_t slot = slotFor(id); index[slot] != 0;
+         slot = (slot + 1) & (index.size() - 1)) {
+      if (ids[index[slot] - 1] == id)
+        return index[slot] - 1;
+    }
+    return npos;
+  }
+};
+
+} // namespace PeakStore
+} // namespace CinderPeak
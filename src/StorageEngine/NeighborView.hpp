@@ -0,0 +1,246 @@
+#pragma once
+#include "StorageEngine/MatrixBlock.hpp"
+#include "StorageEngine/VertexDictionary.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+namespace CinderPeak {
+namespace PeakStore {
+
+// A weight that replaces the one stored at `pos` of a row, for engines whose
+// rows live in storage that readers share and writers may not modify.
+template <typename EdgeType> struct WeightPatch {
+  size_t pos;
+  EdgeType weight;
+};
+
+// Patches sorted by pos.
+template <typename EdgeType> struct PatchRange {
+  const WeightPatch<EdgeType> *first = nullptr;
+  size_t count = 0;
+
+  const EdgeType *find(size_t pos) const {
+    const auto *last = first + count;
+    const auto *it = std::lower_bound(
+        first, last, pos,
+        [](const WeightPatch<EdgeType> &p, size_t at) { return p.pos < at; });
+    return it != last && it->pos == pos ? &it->weight : nullptr;
+  }
+};
+
+// A run of (neighbor id, weight) pairs inside engine storage. Ids and weights
+// advance by their own byte stride, so the same run describes a
+// struct-of-arrays row as well as a slice of array-of-structs records.
+template <typename EdgeType> struct NeighborRun {
+  const unsigned char *ids = nullptr;
+  const unsigned char *weights = nullptr;
+  size_t size = 0;
+  size_t id_stride = sizeof(VertexId);
+  size_t weight_stride = sizeof(EdgeType);
+  // Patches over the run, the first range winning over the second. Their
+  // positions count from `patch_base` rather than from the start of the run.
+  PatchRange<EdgeType> patches[2];
+  size_t patch_base = 0;
+
+  static NeighborRun contiguous(const VertexId *ids, const EdgeType *weights,
+                                size_t size) {
+    NeighborRun run;
+    run.ids = reinterpret_cast<const unsigned char *>(ids);
+    run.weights = reinterpret_cast<const unsigned char *>(weights);
+    run.size = size;
+    return run;
+  }
+  template <typename Record>
+  static NeighborRun strided(const Record *first, size_t size,
+                             const VertexId Record::*id,
+                             const EdgeType Record::*weight) {
+    NeighborRun run;
+    if (size == 0)
+      return run;
+    run.ids = reinterpret_cast<const unsigned char *>(&(first->*id));
+    run.weights = reinterpret_cast<const unsigned char *>(&(first->*weight));
+    run.size = size;
+    run.id_stride = run.weight_stride = sizeof(Record);
+    return run;
+  }
+  NeighborRun withPatches(PatchRange<EdgeType> newer,
+                          PatchRange<EdgeType> older, size_t base) const {
+    NeighborRun run = *this;
+    run.patches[0] = newer;
+    run.patches[1] = older;
+    run.patch_base = base;
+    return run;
+  }
+
+  VertexId id(size_t pos) const {
+    return *reinterpret_cast<const VertexId *>(ids + pos * id_stride);
+  }
+  const EdgeType &weight(size_t pos) const {
+    for (const auto &range : patches) {
+      if (range.count) {
+        if (const EdgeType *patched = range.find(pos + patch_base))
+          return *patched;
+      }
+    }
+    return *reinterpret_cast<const EdgeType *>(weights + pos * weight_stride);
+  }
+};
+
+// Read-only view of one vertex's out-edges that points straight into engine
+// storage. Adjacency lists and CSR rows are exposed as up to two runs (the
+// CSR row and its staged delta); matrix rows are walked bit by bit across
+// the row of blocks. A view is invalidated by any write to the graph, unless
+// the engine hands it the storage it points into to keep alive.
+template <typename VertexType, typename EdgeType> class NeighborView {
+public:
+  static constexpr size_t MAX_RUNS = 2;
+  using Block = MatrixBlock<EdgeType>;
+
+  // Position inside the view: run index and offset for runs, block column
+  // and remaining row bits for matrix rows.
+  struct Cursor {
+    size_t slot = 0;
+    size_t pos = 0;
+    std::uint64_t word = 0;
+    bool operator==(const Cursor &o) const {
+      return slot == o.slot && pos == o.pos && word == o.word;
+    }
+    bool operator!=(const Cursor &o) const { return !(*this == o); }
+  };
+
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<const VertexType &, const EdgeType &>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    iterator() = default;
+    iterator(const NeighborView *view, Cursor cursor)
+        : view(view), cursor(cursor) {}
+
+    VertexId id() const { return view->idAt(cursor); }
+    const VertexType &vertex() const { return view->vertexAt(cursor); }
+    const EdgeType &weight() const { return view->weightAt(cursor); }
+    reference operator*() const { return {vertex(), weight()}; }
+    iterator &operator++() {
+      view->advance(cursor);
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator prev = *this;
+      ++*this;
+      return prev;
+    }
+    bool operator==(const iterator &o) const { return cursor == o.cursor; }
+    bool operator!=(const iterator &o) const { return cursor != o.cursor; }
+
+  private:
+    const NeighborView *view = nullptr;
+    Cursor cursor;
+  };
+  using const_iterator = iterator;
+
+  NeighborView() = default;
+  NeighborView(const VertexDictionary<VertexType> *dictionary,
+               NeighborRun<EdgeType> first,
+               NeighborRun<EdgeType> second = {},
+               std::shared_ptr<const void> keep_alive = nullptr)
+      : dictionary(dictionary), runs{first, second},
+        keep_alive(std::move(keep_alive)) {}
+  NeighborView(const VertexDictionary<VertexType> *dictionary,
+               const std::unique_ptr<Block> *blocks, size_t block_count,
+               size_t block_row)
+      : dictionary(dictionary), blocks(blocks), block_count(block_count),
+        block_row(block_row) {}
+
+  size_t size() const {
+    size_t count = 0;
+    if (blocks) {
+      for (size_t bc = 0; bc < block_count; ++bc)
+        count += countSetBits(rowBits(bc));
+    } else {
+      for (const auto &run : runs)
+        count += run.size;
+    }
+    return count;
+  }
+  bool empty() const { return first() == last(); }
+
+  iterator begin() const { return {this, first()}; }
+  iterator end() const { return {this, last()}; }
+
+  // Cursor-level access for callers that keep a view by value and iterate it
+  // without holding on to an iterator, such as the whole-graph edge range.
+  Cursor first() const {
+    Cursor cursor;
+    if (blocks)
+      cursor.word = block_count ? rowBits(0) : 0;
+    settle(cursor);
+    return cursor;
+  }
+  Cursor last() const {
+    Cursor cursor;
+    cursor.slot = blocks ? block_count : MAX_RUNS;
+    return cursor;
+  }
+  void advance(Cursor &cursor) const {
+    if (blocks)
+      cursor.word &= cursor.word - 1;
+    else
+      ++cursor.pos;
+    settle(cursor);
+  }
+  VertexId idAt(const Cursor &cursor) const {
+    if (blocks)
+      return static_cast<VertexId>(cursor.slot * Block::DIM +
+                                   countTrailingZeros(cursor.word));
+    return runs[cursor.slot].id(cursor.pos);
+  }
+  const VertexType &vertexAt(const Cursor &cursor) const {
+    return dictionary->vertex(idAt(cursor));
+  }
+  const EdgeType &weightAt(const Cursor &cursor) const {
+    if (!blocks)
+      return runs[cursor.slot].weight(cursor.pos);
+    const EdgeType *weight = blocks[cursor.slot]->weight(
+        block_row, countTrailingZeros(cursor.word));
+    return weight ? *weight : noWeight();
+  }
+
+private:
+  const VertexDictionary<VertexType> *dictionary = nullptr;
+  NeighborRun<EdgeType> runs[MAX_RUNS];
+  const std::unique_ptr<Block> *blocks = nullptr;
+  size_t block_count = 0;
+  size_t block_row = 0;
+  std::shared_ptr<const void> keep_alive;
+
+  static const EdgeType &noWeight() {
+    static const EdgeType none{};
+    return none;
+  }
+  std::uint64_t rowBits(size_t bc) const {
+    return blocks[bc] ? blocks[bc]->bits[block_row] : 0;
+  }
+  void settle(Cursor &cursor) const {
+    if (blocks) {
+      while (cursor.word == 0 && cursor.slot < block_count) {
+        ++cursor.slot;
+        cursor.word = cursor.slot < block_count ? rowBits(cursor.slot) : 0;
+      }
+      return;
+    }
+    while (cursor.slot < MAX_RUNS && cursor.pos == runs[cursor.slot].size) {
+      ++cursor.slot;
+      cursor.pos = 0;
+    }
+  }
+};
+
+} // namespace PeakStore
+} // namespace CinderPeak
@@ -0,0 +1,37 @@
+#pragma once
+#include <type_traits>
+namespace CinderPeak {
+template <typename, typename> class PeakStorageInterface;
+namespace PeakStore {
+
+// Storage policies select how a PeakStore binds its storage engine.
+//
+// DynamicStorage keeps the engines behind PeakStorageInterface in the
+// GraphContext. The active engine is chosen at runtime and can be switched
+// by adaptive migration.
+struct DynamicStorage {};
+
+// StaticStorage<Engine> embeds a single Engine<VertexType, EdgeType> in the
+// PeakStore and calls it directly. The engine is fixed for the lifetime of
+// the store, so there is no virtual dispatch, no shared_ptr hop and no
+// migration bookkeeping on the hot path.
+template <template <typename, typename> class Engine> struct StaticStorage {};
+
+template <typename Policy, typename VertexType, typename EdgeType>
+struct storage_engine {
+  using type = PeakStorageInterface<VertexType, EdgeType>;
+  static constexpr bool is_static = false;
+};
+template <template <typename, typename> class Engine, typename VertexType,
+          typename EdgeType>
+struct storage_engine<StaticStorage<Engine>, VertexType, EdgeType> {
+  using type = Engine<VertexType, EdgeType>;
+  static constexpr bool is_static = true;
+};
+
+template <typename VertexType, typename EdgeType,
+          typename StoragePolicy = DynamicStorage>
+class PeakStore;
+
+} // namespace PeakStore
+} // namespace CinderPeak
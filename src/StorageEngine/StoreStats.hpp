@@ -0,0 +1,246 @@
+#pragma once
+#include "Concurrency/StripedCounter.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+namespace CinderPeak {
+namespace PeakStore {
+
+// Operations timed by an instrumented store.
+enum class StoreOp {
+  AddVertex,
+  AddVertices,
+  AddEdge,
+  AddEdges,
+  GetEdge,
+  GetNeighbors,
+  CsrRebuild,
+  Migration,
+  Count,
+};
+
+inline const char *storeOpName(StoreOp op) {
+  switch (op) {
+  case StoreOp::AddVertex:
+    return "add_vertex";
+  case StoreOp::AddVertices:
+    return "add_vertices";
+  case StoreOp::AddEdge:
+    return "add_edge";
+  case StoreOp::AddEdges:
+    return "add_edges";
+  case StoreOp::GetEdge:
+    return "get_edge";
+  case StoreOp::GetNeighbors:
+    return "get_neighbors";
+  case StoreOp::CsrRebuild:
+    return "csr_rebuild";
+  case StoreOp::Migration:
+    return "migration";
+  default:
+    return "unknown";
+  }
+}
+
+// HDR-style latency histogram over nanoseconds. Values below SUB_BUCKETS
+// get a bucket each; above that every power of two is split into
+// SUB_BUCKETS linear buckets, so any recorded value is reported within
+// 1/SUB_BUCKETS (12.5%) of itself. Writers add to a per-thread stripe and
+// summary() merges the stripes.
+class LatencyHistogram {
+public:
+  struct Summary {
+    std::uint64_t count = 0;
+    std::uint64_t total_ns = 0;
+    std::uint64_t max_ns = 0;
+    std::uint64_t p50_ns = 0;
+    std::uint64_t p90_ns = 0;
+    std::uint64_t p99_ns = 0;
+    std::uint64_t p999_ns = 0;
+  };
+
+  void record(std::uint64_t ns) {
+    Stripe &stripe = stripes[Concurrency::threadStripe(STRIPES)];
+    stripe.buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+    stripe.total.fetch_add(ns, std::memory_order_relaxed);
+    std::uint64_t max = stripe.max.load(std::memory_order_relaxed);
+    while (ns > max && !stripe.max.compare_exchange_weak(
+                           max, ns, std::memory_order_relaxed))
+      ;
+  }
+
+  Summary summary() const {
+    std::array<std::uint64_t, BUCKETS> merged{};
+    Summary out;
+    for (const auto &stripe : stripes) {
+      for (size_t b = 0; b < BUCKETS; ++b)
+        merged[b] += stripe.buckets[b].load(std::memory_order_relaxed);
+      out.total_ns += stripe.total.load(std::memory_order_relaxed);
+      out.max_ns =
+          std::max(out.max_ns, stripe.max.load(std::memory_order_relaxed));
+    }
+    for (auto count : merged)
+      out.count += count;
+    out.p50_ns = percentile(merged, out.count, 0.5, out.max_ns);
+    out.p90_ns = percentile(merged, out.count, 0.9, out.max_ns);
+    out.p99_ns = percentile(merged, out.count, 0.99, out.max_ns);
+    out.p999_ns = percentile(merged, out.count, 0.999, out.max_ns);
+    return out;
+  }
+
+private:
+  static constexpr size_t SUB_BITS = 3;
+  static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BITS;
+  // Exponents up to 2^40 ns (about 18 minutes); longer values are clamped.
+  static constexpr size_t MAX_EXPONENT = 40;
+  static constexpr size_t BUCKETS =
+      SUB_BUCKETS + (MAX_EXPONENT - SUB_BITS + 1) * SUB_BUCKETS;
+  static constexpr size_t STRIPES = 8;
+
+  struct alignas(64) Stripe {
+    std::array<std::atomic<std::uint64_t>, BUCKETS> buckets{};
+    std::atomic<std::uint64_t> total{0};
+    std::atomic<std::uint64_t> max{0};
+  };
+  Stripe stripes[STRIPES];
+
+  static size_t bucketOf(std::uint64_t ns) {
+    if (ns < SUB_BUCKETS)
+      return static_cast<size_t>(ns);
+    size_t exponent = 0;
+#if defined(__GNUC__) || defined(__clang__)
+    exponent = 63 - static_cast<size_t>(__builtin_clzll(ns));
+#else
+    while (ns >> (exponent + 1))
+      ++exponent;
+#endif
+    if (exponent > MAX_EXPONENT)
+      return BUCKETS - 1;
+    const size_t sub = (ns >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1);
+    return SUB_BUCKETS + (exponent - SUB_BITS) * SUB_BUCKETS + sub;
+  }
+  // Largest value that falls in bucket `b`.
+  static std::uint64_t bucketCeiling(size_t b) {
+    if (b < SUB_BUCKETS)
+      return b;
+    const size_t exponent = (b - SUB_BUCKETS) / SUB_BUCKETS + SUB_BITS;
+    const std::uint64_t sub = (b - SUB_BUCKETS) % SUB_BUCKETS;
+    const std::uint64_t width = std::uint64_t{1} << (exponent - SUB_BITS);
+    return (std::uint64_t{1} << exponent) + (sub + 1) * width - 1;
+  }
+  static std::uint64_t
+  percentile(const std::array<std::uint64_t, BUCKETS> &merged,
+             std::uint64_t count, double q, std::uint64_t max) {
+    if (count == 0)
+      return 0;
+    const auto rank = static_cast<std::uint64_t>(q * (count - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (size_t b = 0; b < BUCKETS; ++b) {
+      seen += merged[b];
+      if (seen >= rank)
+        return std::min(bucketCeiling(b), max);
+    }
+    return max;
+  }
+};
+
+// Point-in-time view of a store returned by PeakStore::stats().
+struct StatsSnapshot {
+  struct Operation {
+    std::string name;
+    LatencyHistogram::Summary latency;
+  };
+  struct Engine {
+    std::string name;
+    size_t bytes = 0;
+  };
+
+  bool instrumented = false;
+  std::string active_storage;
+  size_t num_vertices = 0;
+  size_t num_edges = 0;
+  size_t num_self_loops = 0;
+  size_t num_parallel_edges = 0;
+  double density = 0.0;
+  // Empty unless the store was created with
+  // GraphCreationOptions::Instrumented.
+  std::vector<Operation> operations;
+  std::vector<Engine> engines;
+
+  std::string toJson() const {
+    std::ostringstream out;
+    out << "{\"instrumented\":" << (instrumented ? "true" : "false")
+        << ",\"active_storage\":\"" << active_storage << "\""
+        << ",\"num_vertices\":" << num_vertices
+        << ",\"num_edges\":" << num_edges
+        << ",\"num_self_loops\":" << num_self_loops
+        << ",\"num_parallel_edges\":" << num_parallel_edges
+        << ",\"density\":" << std::setprecision(17) << density
+        << ",\"operations\":{";
+    for (size_t i = 0; i < operations.size(); ++i) {
+      const auto &l = operations[i].latency;
+      out << (i ? "," : "") << "\"" << operations[i].name << "\":{"
+          << "\"count\":" << l.count << ",\"total_ns\":" << l.total_ns
+          << ",\"max_ns\":" << l.max_ns << ",\"p50_ns\":" << l.p50_ns
+          << ",\"p90_ns\":" << l.p90_ns << ",\"p99_ns\":" << l.p99_ns
+          << ",\"p999_ns\":" << l.p999_ns << "}";
+    }
+    out << "},\"engines\":{";
+    for (size_t i = 0; i < engines.size(); ++i) {
+      out << (i ? "," : "") << "\"" << engines[i].name << "\":{\"bytes\":"
+          << engines[i].bytes << "}";
+    }
+    out << "}}";
+    return out.str();
+  }
+};
+
+// Latency histograms of an instrumented store, shared with its engines so
+// that CSR rebuilds are timed where they happen.
+class StoreStats {
+public:
+  // Times the enclosing scope into `op`; does nothing for a null `stats`,
+  // which is how uninstrumented stores opt out.
+  class Timer {
+  public:
+    Timer(StoreStats *stats, StoreOp op) : stats(stats), op(op) {
+      if (stats)
+        start = std::chrono::steady_clock::now();
+    }
+    Timer(const Timer &) = delete;
+    Timer &operator=(const Timer &) = delete;
+    ~Timer() {
+      if (stats)
+        stats->record(op, std::chrono::steady_clock::now() - start);
+    }
+
+  private:
+    StoreStats *stats;
+    StoreOp op;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  void record(StoreOp op, std::chrono::steady_clock::duration elapsed) {
+    const auto ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    histograms[static_cast<size_t>(op)].record(
+        static_cast<std::uint64_t>(std::max<decltype(ns)>(ns, 0)));
+  }
+  LatencyHistogram::Summary summary(StoreOp op) const {
+    return histograms[static_cast<size_t>(op)].summary();
+  }
+
+private:
+  std::array<LatencyHistogram, static_cast<size_t>(StoreOp::Count)>
+      histograms;
+};
+
+} // namespace PeakStore
+} // namespace CinderPeak
@@ -1,7 +1,9 @@
 #pragma once
 #include "CinderExceptions.hpp"
+#include "Concurrency/StripedCounter.hpp"
 #include "ErrorCodes.hpp"
 #include "PeakLogger.hpp"
+#include <atomic>
 #include <bitset>
 #include <chrono>
 #include <functional>
@@ -23,6 +25,13 @@ public:
     ParallelEdges,
     Undirected,
     Unweighted,
+    // Allow vertex and edge insertions and lookups from several threads at
+    // once. Only honored by adjacency-list graphs, which then stay on the
+    // list instead of adapting their storage.
+    Concurrent,
+    // Record per-operation latency histograms and CSR rebuild times,
+    // reported by PeakStore::stats().
+    Instrumented,
   };
   GraphCreationOptions(std::initializer_list<GraphType> graph_types) {
     for (auto type : graph_types) {
@@ -38,9 +47,33 @@ public:
 
   bool hasOption(GraphType type) const { return options.test(type); }
 
+  // Size of the thread pool used for parallel storage work such as CSR
+  // builds. 0 shares the process-wide Concurrency::ThreadPool::global().
+  GraphCreationOptions &setThreads(size_t count) {
+    threads = count;
+    return *this;
+  }
+  size_t threadCount() const { return threads; }
+
 private:
   std::bitset<8> options;
+  size_t threads = 0;
+};
+
+// How PeakStorageInterface::impl_insertEdge treats an edge that already
+// exists.
+enum class EdgeInsertMode {
+  InsertIfAbsent, // leave the existing edge untouched
+  Upsert,         // overwrite the existing edge's weight
+  AllowParallel,  // always append a new edge
 };
+enum class EdgeInsertResult {
+  Inserted,
+  InsertedParallel, // AllowParallel insert next to an existing (src, dest)
+  Updated,
+  Existing,
+};
+
 template <typename T, typename Enable = void> struct VertexHasher;
 template <typename T, typename Enable = void> struct EdgeHasher;
 
@@ -150,23 +183,29 @@ size_t CinderPeak::CinderEdge::nextId = 1;
 namespace PeakStore {
 class GraphInternalMetadata {
 public:
-  size_t density;
-  size_t num_vertices;
-  size_t num_edges;
-  size_t num_self_loops;
-  size_t num_parallel_edges;
+  // Maintained by PeakStore on every write and summed on read, so they stay
+  // cheap to bump from concurrent writers and O(1) to query.
+  Concurrency::StripedCounter num_vertices;
+  Concurrency::StripedCounter num_edges;
+  Concurrency::StripedCounter num_self_loops;
+  // Edges beyond the first between the same (src, dest) pair.
+  Concurrency::StripedCounter num_parallel_edges;
   const std::string graph_type;
   bool is_vertex_type_primitive;
   bool is_edge_type_primitive;
+  bool directed = true;
   GraphInternalMetadata(const std::string &graph_type, bool vertex_tp_p,
                         bool edge_tp_p)
       : graph_type(graph_type), is_vertex_type_primitive(vertex_tp_p),
-        is_edge_type_primitive(edge_tp_p) {
-    num_vertices = 0;
-    num_edges = 0;
-    density = 0;
-    num_self_loops = 0;
-    num_parallel_edges = 0;
+        is_edge_type_primitive(edge_tp_p) {}
+  // Edges over the number of possible (src, dest) pairs without self loops;
+  // a multigraph or a graph with self loops can exceed 1.
+  double density() const {
+    const double v = static_cast<double>(num_vertices.load());
+    if (v < 2)
+      return 0.0;
+    const double pairs = directed ? v * (v - 1) : v * (v - 1) / 2;
+    return static_cast<double>(num_edges.load()) / pairs;
   }
   // default ctor for basic testing, this has to be removed later on.
   GraphInternalMetadata() {}
@@ -182,6 +221,9 @@ inline void handle_exception_map(const PeakStatus &status) {
   case static_cast<int>(StatusCode::NOT_FOUND):
     LOG_INFO("Resource Not Found");
     break;
+  case static_cast<int>(StatusCode::INVALID_ARGUMENT):
+    LOG_ERROR("Invalid argument");
+    break;
   case static_cast<int>(StatusCode::UNIMPLEMENTED):
     LOG_WARNING("Called an Unimplemented method");
     break;
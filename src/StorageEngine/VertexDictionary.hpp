@@ -0,0 +1,116 @@
+#pragma once
+#include "Utils.hpp"
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+namespace CinderPeak {
+namespace PeakStore {
+
+// Storage engines refer to vertices by dense integer ids handed out by a
+// VertexDictionary. Define CINDERPEAK_64BIT_VERTEX_IDS for graphs with more
+// than 2^32 - 1 vertices.
+#ifdef CINDERPEAK_64BIT_VERTEX_IDS
+using VertexId = std::uint64_t;
+#else
+using VertexId = std::uint32_t;
+#endif
+inline constexpr VertexId INVALID_VERTEX_ID =
+    std::numeric_limits<VertexId>::max();
+
+// Number of shards used by concurrent dictionaries and the engines that
+// share them. Must be a power of two.
+inline constexpr size_t CONCURRENT_SHARD_BITS = 6;
+
+// The dictionary is split into 2^shardBits() shards by vertex hash. The low
+// bits of an id name the shard that owns it and the high bits its slot in
+// that shard, so engines can shard rows by id and land on the same
+// partition. A single-threaded dictionary has one shard and hands out
+// 0, 1, 2, ...; a concurrent one locks each shard with a reader-writer lock.
+template <typename VertexType> class VertexDictionary {
+private:
+  struct Shard {
+    mutable std::shared_mutex mutex;
+    std::unordered_map<VertexType, VertexId, VertexHasher<VertexType>> ids;
+    // Points at the keys of `ids`; unordered_map never moves its nodes.
+    std::vector<const VertexType *> vertices;
+  };
+
+  size_t shard_bits;
+  bool concurrent;
+  std::unique_ptr<Shard[]> shards;
+  std::atomic<size_t> count{0};
+
+  Shard &shardFor(const VertexType &v) const {
+    if (shard_bits == 0)
+      return shards[0];
+    const size_t h = VertexHasher<VertexType>()(v);
+    // Mix the hash so that identity hashes of small integers spread evenly.
+    const std::uint64_t mixed =
+        static_cast<std::uint64_t>(h) * 0x9E3779B97F4A7C15ull;
+    return shards[mixed >> (64 - shard_bits)];
+  }
+  std::shared_lock<std::shared_mutex> readLock(const Shard &shard) const {
+    if (!concurrent)
+      return {};
+    return std::shared_lock<std::shared_mutex>(shard.mutex);
+  }
+
+public:
+  explicit VertexDictionary(bool concurrent = false)
+      : shard_bits(concurrent ? CONCURRENT_SHARD_BITS : 0),
+        concurrent(concurrent),
+        shards(std::make_unique<Shard[]>(size_t{1} << shard_bits)) {}
+
+  bool isConcurrent() const { return concurrent; }
+  size_t shardBits() const { return shard_bits; }
+
+  // Returns the id of `v`, assigning the next free id if it is new. The
+  // second member is true when `v` was inserted.
+  std::pair<VertexId, bool> intern(const VertexType &v) {
+    Shard &shard = shardFor(v);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex, std::defer_lock);
+    if (concurrent)
+      lock.lock();
+    const size_t shard_index = &shard - shards.get();
+    const VertexId id = static_cast<VertexId>(
+        (shard.vertices.size() << shard_bits) | shard_index);
+    auto [it, inserted] = shard.ids.try_emplace(v, id);
+    if (inserted) {
+      shard.vertices.push_back(&it->first);
+      count.fetch_add(1, std::memory_order_relaxed);
+    }
+    return {it->second, inserted};
+  }
+  VertexId find(const VertexType &v) const {
+    const Shard &shard = shardFor(v);
+    auto lock = readLock(shard);
+    auto it = shard.ids.find(v);
+    return it == shard.ids.end() ? INVALID_VERTEX_ID : it->second;
+  }
+  const VertexType &vertex(VertexId id) const {
+    const Shard &shard = shards[id & ((size_t{1} << shard_bits) - 1)];
+    auto lock = readLock(shard);
+    return *shard.vertices[id >> shard_bits];
+  }
+  size_t size() const { return count.load(std::memory_order_relaxed); }
+  void reserve(size_t n) {
+    const size_t per_shard = (n >> shard_bits) + 1;
+    for (size_t s = 0; s < (size_t{1} << shard_bits); ++s) {
+      std::unique_lock<std::shared_mutex> lock(shards[s].mutex,
+                                               std::defer_lock);
+      if (concurrent)
+        lock.lock();
+      shards[s].ids.reserve(per_shard);
+      shards[s].vertices.reserve(per_shard);
+    }
+  }
+};
+
+} // namespace PeakStore
+} // namespace CinderPeak
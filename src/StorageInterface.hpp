@@ -2,10 +2,15 @@
 #include "StorageEngine/AdjacencyList.hpp"
 #include "StorageEngine/ErrorCodes.hpp"
 #include "StorageEngine/HybridCSR_COO.hpp"
+#include "StorageEngine/NeighborView.hpp"
 #include "StorageEngine/Utils.hpp"
+#include <tuple>
+#include <vector>
 namespace CinderPeak {
 template <typename VertexType, typename EdgeType> class PeakStorageInterface {
 public:
+  using EdgeBatch = std::vector<std::tuple<VertexType, VertexType, EdgeType>>;
+
   // virtual void exc() const = 0;
   virtual const PeakStatus impl_addVertex(const VertexType &src) = 0;
   virtual const PeakStatus impl_addEdge(const VertexType &src,
@@ -13,12 +18,68 @@ public:
   virtual const PeakStatus impl_addEdge(const VertexType &src,
                                         const VertexType &dest,
                                         const EdgeType &weight) = 0;
+  // Looks up the source row once and inserts, updates or reports the edge
+  // according to `mode`.
+  virtual const std::pair<EdgeInsertResult, PeakStatus>
+  impl_insertEdge(const VertexType &src, const VertexType &dest,
+                  const EdgeType &weight, EdgeInsertMode mode) = 0;
   virtual bool impl_doesEdgeExist(const VertexType &src, const VertexType &dest,
                                   const EdgeType &weight) = 0;
   virtual bool impl_doesEdgeExist(const VertexType &src,
                                   const VertexType &dest) = 0;
   virtual const std::pair<EdgeType, PeakStatus>
   impl_getEdge(const VertexType &src, const VertexType &dest) = 0;
+  virtual const std::pair<std::vector<std::pair<VertexType, EdgeType>>,
+                          PeakStatus>
+  impl_getNeighbors(const VertexType &vertex) const = 0;
+
+  // Zero-copy neighbor access. Views point into engine storage and stay
+  // valid until the next write.
+  virtual std::pair<PeakStore::NeighborView<VertexType, EdgeType>, PeakStatus>
+  impl_neighbors(const VertexType &vertex) = 0;
+
+  // Id-level access; ids come from the shared VertexDictionary.
+  virtual size_t impl_rowCount() const = 0;
+  virtual bool impl_hasRow(PeakStore::VertexId id) const = 0;
+  virtual PeakStore::NeighborView<VertexType, EdgeType>
+  impl_neighborsById(PeakStore::VertexId id) = 0;
+
+  // Bulk entry points. Existing vertices are skipped; the returned count is
+  // the number of vertices or edges actually inserted. Engines override these
+  // to avoid the per-element overhead of the single-element calls. When
+  // `parallel` is given it receives how many inserted edges repeat a
+  // (src, dest) pair that was already stored or came earlier in the batch.
+  virtual const std::pair<size_t, PeakStatus>
+  impl_addVertices(const std::vector<VertexType> &vertices) {
+    size_t added = 0;
+    for (const auto &v : vertices) {
+      if (impl_addVertex(v).isOK())
+        added++;
+    }
+    return {added, PeakStatus::OK()};
+  }
+  virtual const std::pair<size_t, PeakStatus>
+  impl_addEdges(const EdgeBatch &edges, size_t *parallel = nullptr) {
+    size_t added = 0;
+    for (const auto &[src, dest, weight] : edges) {
+      if (!parallel) {
+        if (auto status = impl_addEdge(src, dest, weight); !status.isOK())
+          return {added, status};
+      } else {
+        auto [result, status] =
+            impl_insertEdge(src, dest, weight, EdgeInsertMode::AllowParallel);
+        if (!status.isOK())
+          return {added, status};
+        *parallel += result == EdgeInsertResult::InsertedParallel;
+      }
+      added++;
+    }
+    return {added, PeakStatus::OK()};
+  }
+
+  // Approximate heap bytes held by the engine itself, not counting the
+  // shared vertex dictionary. Must not overlap writes.
+  virtual size_t impl_bytesAllocated() const { return 0; }
 
   virtual ~PeakStorageInterface() = default;
 };
@@ -20,7 +20,7 @@ public:
 
   explicit GraphVisualizer(AdjListType adj_list) : _adj_list(adj_list) {
     LOG_DEBUG("GOT ADJACENCY LIST WITH SIZE: ");
-    LOG_DEBUG(std::to_string(_adj_list.size()));
+    LOG_DEBUG("{}", _adj_list.size());
   }
 
   void visualize_primitives_graph() {
@@ -194,3 +194,131 @@ TEST(AdjacencyListCustomTest, CustomVertexType) {
     EXPECT_TRUE(edge.second.isOK());
     EXPECT_FLOAT_EQ(edge.first, 3.14f);
 }
+
+//
+// 8. Bulk Operations
+//
+
+TEST_F(AdjacencyListTest, BulkAddVerticesSkipsExisting) {
+    auto [added, status] = intGraph.impl_addVertices({3, 4, 5, 4});
+    EXPECT_TRUE(status.isOK());
+    EXPECT_EQ(added, 2);
+    EXPECT_EQ(intGraph.getAdjList().size(), 5);
+}
+
+TEST_F(AdjacencyListTest, BulkAddEdges) {
+    auto [added, status] = intGraph.impl_addEdges({{1, 2, 5}, {1, 3, 6}, {3, 1, 7}});
+    EXPECT_TRUE(status.isOK());
+    EXPECT_EQ(added, 3);
+    EXPECT_EQ(intGraph.impl_getEdge(1, 3).first, 6);
+    EXPECT_EQ(intGraph.impl_getEdge(3, 1).first, 7);
+}
+
+TEST_F(AdjacencyListTest, BulkAddEdgesRejectsUnknownVertex) {
+    auto [added, status] = intGraph.impl_addEdges({{1, 2, 5}, {1, 99, 6}});
+    EXPECT_EQ(status.code(), StatusCode::VERTEX_NOT_FOUND);
+    EXPECT_EQ(added, 0);
+    EXPECT_EQ(intGraph.impl_getEdge(1, 2).second.code(), StatusCode::EDGE_NOT_FOUND);
+}
+
+//
+// 9. Vertex Interning
+//
+
+TEST(AdjacencyListDictionaryTest, SharedDictionaryAssignsDenseIds) {
+    auto dictionary = std::make_shared<VertexDictionary<std::string>>();
+    AdjacencyList<std::string, int> graph(dictionary);
+
+    graph.impl_addVertex("A");
+    graph.impl_addVertex("B");
+    graph.impl_addVertex("A");
+    EXPECT_EQ(dictionary->size(), 2);
+    EXPECT_EQ(dictionary->find("B"), 1);
+    EXPECT_EQ(dictionary->vertex(0), "A");
+    EXPECT_EQ(dictionary->find("Z"), INVALID_VERTEX_ID);
+
+    // A vertex interned elsewhere is not part of this list until added.
+    dictionary->intern("C");
+    EXPECT_EQ(graph.impl_addEdge("A", "C").code(), StatusCode::VERTEX_NOT_FOUND);
+    EXPECT_TRUE(graph.impl_addVertex("C").isOK());
+    EXPECT_TRUE(graph.impl_addEdge("A", "C", 7).isOK());
+    EXPECT_EQ(graph.impl_getEdge("A", "C").first, 7);
+}
+
+//
+// 10. High-Degree Rows
+//
+
+TEST(AdjacencyListHubTest, IndexedLookupOnHubVertex) {
+    AdjacencyList<int, int> graph;
+    const int degree = 4 * NeighborList<int>::INDEX_THRESHOLD + 3;
+    for (int v = 0; v <= degree; ++v)
+        graph.impl_addVertex(v);
+    for (int v = degree; v >= 1; --v)
+        graph.impl_addEdge(0, v, v * 2);
+    graph.impl_addEdge(0, 5, -1); // parallel edge; the first one wins
+
+    for (int v = 1; v <= degree; ++v) {
+        auto edge = graph.impl_getEdge(0, v);
+        ASSERT_TRUE(edge.second.isOK());
+        EXPECT_EQ(edge.first, v * 2);
+    }
+    EXPECT_FALSE(graph.impl_doesEdgeExist(1, 0));
+    EXPECT_EQ(graph.impl_getEdge(0, 0).second.code(), StatusCode::EDGE_NOT_FOUND);
+
+    auto neighbors = graph.impl_getNeighbors(0);
+    ASSERT_EQ(neighbors.first.size(), degree + 1);
+    EXPECT_EQ(neighbors.first.front().first, degree);
+    EXPECT_EQ(neighbors.first.back().second, -1);
+}
+
+//
+// 11. Insert-or-Find
+//
+
+TEST(AdjacencyListInsertTest, ReportsInsertedUpdatedExisting) {
+    AdjacencyList<int, int> graph;
+    graph.impl_addVertex(1);
+    graph.impl_addVertex(2);
+
+    auto first = graph.impl_insertEdge(1, 2, 5, EdgeInsertMode::InsertIfAbsent);
+    EXPECT_TRUE(first.second.isOK());
+    EXPECT_EQ(first.first, EdgeInsertResult::Inserted);
+    EXPECT_EQ(graph.impl_insertEdge(1, 2, 6, EdgeInsertMode::InsertIfAbsent).first,
+              EdgeInsertResult::Existing);
+    EXPECT_EQ(graph.impl_getEdge(1, 2).first, 5);
+
+    EXPECT_EQ(graph.impl_insertEdge(1, 2, 7, EdgeInsertMode::Upsert).first,
+              EdgeInsertResult::Updated);
+    EXPECT_EQ(graph.impl_getEdge(1, 2).first, 7);
+
+    EXPECT_EQ(graph.impl_insertEdge(1, 2, 8, EdgeInsertMode::AllowParallel).first,
+              EdgeInsertResult::InsertedParallel);
+    EXPECT_EQ(graph.impl_getNeighbors(1).first.size(), 2);
+
+    EXPECT_EQ(graph.impl_insertEdge(1, 99, 1, EdgeInsertMode::Upsert).second.code(),
+              StatusCode::VERTEX_NOT_FOUND);
+}
+
+//
+// 12. Neighbor Views
+//
+
+TEST(AdjacencyListViewTest, ViewReadsRowInPlace) {
+    AdjacencyList<int, int> graph;
+    for (int v = 1; v <= 4; ++v)
+        graph.impl_addVertex(v);
+    graph.impl_addEdge(1, 3, 13);
+    graph.impl_addEdge(1, 2, 12);
+
+    auto [view, status] = graph.impl_neighbors(1);
+    ASSERT_TRUE(status.isOK());
+    ASSERT_EQ(view.size(), 2);
+    std::vector<std::pair<int, int>> seen;
+    for (auto [vertex, weight] : view)
+        seen.emplace_back(vertex, weight);
+    EXPECT_EQ(seen, (std::vector<std::pair<int, int>>{{3, 13}, {2, 12}}));
+
+    EXPECT_TRUE(graph.impl_neighbors(4).first.empty());
+    EXPECT_EQ(graph.impl_neighbors(99).second.code(), StatusCode::VERTEX_NOT_FOUND);
+}
@@ -0,0 +1,585 @@
+#include <gtest/gtest.h>
+#include "CinderPeak.hpp"
+#include <algorithm>
+#include <queue>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace CinderPeak;
+using namespace CinderPeak::Algorithms;
+using PeakStore::StaticStorage;
+
+namespace {
+
+using Edges = std::vector<std::tuple<int, int, int>>;
+
+// Directed G(n, m) with weights in [1, 100], no self loops.
+Edges randomEdges(int vertices, int edges, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> vertex(0, vertices - 1);
+    std::uniform_int_distribution<int> weight(1, 100);
+    Edges out;
+    while (static_cast<int>(out.size()) < edges) {
+        int src = vertex(rng), dest = vertex(rng);
+        if (src != dest)
+            out.emplace_back(src, dest, weight(rng));
+    }
+    return out;
+}
+
+template <typename Graph>
+void load(Graph &graph, int vertices, const Edges &edges) {
+    std::vector<int> ids(vertices);
+    for (int v = 0; v < vertices; ++v)
+        ids[v] = v;
+    graph.addVertices(ids);
+    graph.addEdges(edges);
+}
+
+std::vector<VertexId> referenceBfs(const CsrSnapshot<int> &graph,
+                                   VertexId source) {
+    std::vector<VertexId> distance(graph.numVertices(), BfsResult::UNREACHED);
+    std::queue<VertexId> queue;
+    distance[source] = 0;
+    queue.push(source);
+    while (!queue.empty()) {
+        VertexId u = queue.front();
+        queue.pop();
+        for (size_t e = graph.offsets()[u]; e < graph.offsets()[u + 1]; ++e) {
+            VertexId v = graph.cols()[e];
+            if (distance[v] == BfsResult::UNREACHED) {
+                distance[v] = distance[u] + 1;
+                queue.push(v);
+            }
+        }
+    }
+    return distance;
+}
+
+} // namespace
+
+//
+// 1. CSR Snapshots
+//
+
+TEST(CsrSnapshotTest, EnginesAgreeAndRowsAreSorted) {
+    GraphCreationOptions options({GraphCreationOptions::Directed,
+                                  GraphCreationOptions::Weighted});
+    GraphList<int, int> list(options);
+    GraphList<int, int, StaticStorage<PeakStore::HybridCSR_COO>> csr(options);
+    Edges edges = randomEdges(200, 1500, 7);
+    load(list, 200, edges);
+    load(csr, 200, edges);
+    csr.addVertex(1000); // added after the CSR was built
+
+    auto a = list.csrSnapshot();
+    auto b = csr.csrSnapshot();
+    EXPECT_EQ(a.numVertices(), 200u);
+    ASSERT_EQ(b.numVertices(), 201u);
+    EXPECT_EQ(b.degree(csr.vertexId(1000)), 0u);
+    ASSERT_EQ(a.numEdges(), b.numEdges());
+    for (VertexId v = 0; v < 200; ++v) {
+        ASSERT_EQ(a.degree(v), b.degree(v));
+        for (size_t e = a.offsets()[v]; e < a.offsets()[v + 1]; ++e) {
+            if (e > a.offsets()[v]) {
+                EXPECT_LE(a.cols()[e - 1], a.cols()[e]);
+            }
+            EXPECT_EQ(list.vertexAt(a.cols()[e]), csr.vertexAt(b.cols()[e]));
+            EXPECT_EQ(a.weightData()[e], b.weightData()[e]);
+        }
+    }
+
+    // Snapshots share immutable arrays and survive later writes.
+    csr.addEdge(0, 1000, 5);
+    EXPECT_EQ(b.numVertices(), 201u);
+    EXPECT_EQ(csr.csrSnapshot().numEdges(), b.numEdges() + 1);
+}
+
+TEST(CsrSnapshotTest, TransposeReversesEveryEdge) {
+    Concurrency::ThreadPool pool(4);
+    CsrSnapshot<int> graph({0, 2, 3, 3, 4}, {1, 3, 3, 0}, {10, 11, 12, 13});
+    auto t = graph.transposed(pool, true);
+    ASSERT_EQ(t.numVertices(), 4u);
+    EXPECT_EQ(*t.row_offsets, (std::vector<size_t>{0, 1, 2, 2, 4}));
+    EXPECT_EQ(*t.col_vals, (std::vector<VertexId>{3, 0, 0, 1}));
+    EXPECT_EQ(*t.weights, (std::vector<int>{13, 10, 11, 12}));
+    EXPECT_FALSE(graph.transposed(pool).hasWeights());
+}
+
+//
+// 2. Breadth-First Search
+//
+
+TEST(BfsTest, DistancesAndParentsOnAPath) {
+    GraphList<std::string, int> graph;
+    for (const char *v : {"a", "b", "c", "d", "island"})
+        graph.addVertex(v);
+    graph.addEdge("a", "b");
+    graph.addEdge("b", "c");
+    graph.addEdge("a", "c");
+    graph.addEdge("c", "d");
+
+    BfsResult result = graph.bfs("a");
+    auto id = [&](const char *v) { return graph.vertexId(v); };
+    EXPECT_EQ(result.reached, 4u);
+    EXPECT_EQ(result.distances[id("a")], 0u);
+    EXPECT_EQ(result.distances[id("b")], 1u);
+    EXPECT_EQ(result.distances[id("c")], 1u);
+    EXPECT_EQ(result.distances[id("d")], 2u);
+    EXPECT_EQ(result.distances[id("island")], BfsResult::UNREACHED);
+    EXPECT_EQ(result.parents[id("a")], id("a"));
+    EXPECT_EQ(graph.vertexAt(result.parents[id("d")]), "c");
+    EXPECT_EQ(result.parents[id("island")], PeakStore::INVALID_VERTEX_ID);
+}
+
+TEST(BfsTest, DirectionOptimizingMatchesSerialSearch) {
+    GraphList<int, int> graph(GraphCreationOptions(
+        {GraphCreationOptions::Directed, GraphCreationOptions::Weighted}));
+    load(graph, 3000, randomEdges(3000, 30000, 11));
+    auto snapshot = graph.csrSnapshot();
+    Concurrency::ThreadPool pool(4);
+    auto transpose = snapshot.transposed(pool);
+
+    // Default thresholds, always bottom-up after the first step, top-down
+    // only, and low thresholds that switch back and forth.
+    for (BfsOptions options : {BfsOptions{}, BfsOptions{1e18, 1e18},
+                               BfsOptions{1e-9, 18}, BfsOptions{2, 2}}) {
+        for (VertexId source : {VertexId{0}, VertexId{1234}}) {
+            BfsResult result = bfs(snapshot, source, pool, options, &transpose);
+            std::vector<VertexId> expected = referenceBfs(snapshot, source);
+            ASSERT_EQ(result.distances, expected);
+            for (VertexId v = 0; v < snapshot.numVertices(); ++v) {
+                if (v == source || expected[v] == BfsResult::UNREACHED)
+                    continue;
+                VertexId p = result.parents[v];
+                ASSERT_EQ(result.distances[p] + 1, result.distances[v]);
+                const VertexId *row = snapshot.cols() + snapshot.offsets()[p];
+                EXPECT_TRUE(
+                    std::binary_search(row, row + snapshot.degree(p), v));
+            }
+        }
+    }
+    // The transpose is built on demand when not passed in.
+    BfsOptions bottom_up{1e18, 1e18};
+    EXPECT_EQ(bfs(snapshot, VertexId{5}, pool, bottom_up).distances,
+              referenceBfs(snapshot, 5));
+}
+
+//
+// 3. Shortest Paths
+//
+
+TEST(SsspTest, WeightedDistancesFromGraphList) {
+    GraphList<std::string, double> graph(GraphCreationOptions(
+        {GraphCreationOptions::Directed, GraphCreationOptions::Weighted}));
+    for (const char *v : {"a", "b", "c", "d", "island"})
+        graph.addVertex(v);
+    graph.addEdge("a", "b", 4.0);
+    graph.addEdge("a", "c", 1.0);
+    graph.addEdge("c", "b", 2.0);
+    graph.addEdge("b", "d", 0.5);
+
+    auto result = graph.shortestPaths("a");
+    auto id = [&](const char *v) { return graph.vertexId(v); };
+    EXPECT_EQ(result.reached, 4u);
+    EXPECT_DOUBLE_EQ(result.distances[id("a")], 0.0);
+    EXPECT_DOUBLE_EQ(result.distances[id("b")], 3.0);
+    EXPECT_DOUBLE_EQ(result.distances[id("c")], 1.0);
+    EXPECT_DOUBLE_EQ(result.distances[id("d")], 3.5);
+    EXPECT_EQ(result.distances[id("island")],
+              SsspResult<double>::UNREACHABLE);
+}
+
+TEST(SsspTest, DeltaSteppingMatchesDijkstra) {
+    GraphList<int, int> graph(GraphCreationOptions(
+        {GraphCreationOptions::Directed, GraphCreationOptions::Weighted}));
+    load(graph, 4000, randomEdges(4000, 40000, 5));
+    auto snapshot = graph.csrSnapshot();
+    Concurrency::ThreadPool pool(4);
+
+    SsspOptions dijkstra;
+    dijkstra.dijkstra_below_edges = snapshot.numEdges() + 1;
+    auto [expected, ok] = sssp(snapshot, VertexId{0}, pool, dijkstra);
+    ASSERT_TRUE(ok.isOK());
+    EXPECT_GT(expected.reached, 3900u);
+    // Automatic, narrow and very wide buckets.
+    for (double delta : {0.0, 1.0, 1e6}) {
+        SsspOptions options;
+        options.delta = delta;
+        options.dijkstra_below_edges = 0;
+        auto [result, status] = sssp(snapshot, VertexId{0}, pool, options);
+        ASSERT_TRUE(status.isOK());
+        EXPECT_EQ(result.distances, expected.distances);
+        EXPECT_EQ(result.reached, expected.reached);
+    }
+}
+
+TEST(SsspTest, RejectsNegativeWeights) {
+    Concurrency::ThreadPool pool(2);
+    CsrSnapshot<double> graph({0, 1, 2, 2}, {1, 2}, {1.5, -0.5});
+    auto [result, status] = sssp(graph, VertexId{0}, pool);
+    EXPECT_EQ(status.code(), StatusCode::INVALID_ARGUMENT);
+    EXPECT_TRUE(result.distances.empty());
+}
+
+//
+// 4. PageRank
+//
+
+namespace {
+
+// Push-style power iteration with dangling mass spread uniformly.
+std::vector<double> referencePageRank(const CsrSnapshot<int> &graph,
+                                      double damping, size_t iterations) {
+    const size_t n = graph.numVertices();
+    std::vector<double> rank(n, 1.0 / n), next(n);
+    for (size_t it = 0; it < iterations; ++it) {
+        double dangling = 0;
+        std::fill(next.begin(), next.end(), 0.0);
+        for (VertexId u = 0; u < n; ++u) {
+            if (graph.degree(u) == 0) {
+                dangling += rank[u];
+                continue;
+            }
+            for (size_t e = graph.offsets()[u]; e < graph.offsets()[u + 1]; ++e)
+                next[graph.cols()[e]] += rank[u] / graph.degree(u);
+        }
+        for (size_t v = 0; v < n; ++v)
+            next[v] = (1 - damping + damping * dangling) / n + damping * next[v];
+        rank.swap(next);
+    }
+    return rank;
+}
+
+} // namespace
+
+TEST(PageRankTest, MatchesPowerIterationInFloatAndDouble) {
+    GraphList<int, int> graph(GraphCreationOptions(
+        {GraphCreationOptions::Directed, GraphCreationOptions::Weighted}));
+    load(graph, 2000, randomEdges(2000, 12000, 21));
+    graph.addVertex(5000); // dangling and unreachable
+    auto snapshot = graph.csrSnapshot();
+    Concurrency::ThreadPool pool(4);
+
+    PageRankOptions options;
+    options.tolerance = 1e-12;
+    auto [ranks, status] = pageRank(snapshot, pool, options);
+    ASSERT_TRUE(status.isOK());
+    EXPECT_TRUE(ranks.converged);
+    std::vector<double> expected =
+        referencePageRank(snapshot, options.damping, ranks.iterations);
+    double sum = 0;
+    for (size_t v = 0; v < expected.size(); ++v) {
+        EXPECT_NEAR(ranks.ranks[v], expected[v], 1e-12);
+        sum += ranks.ranks[v];
+    }
+    EXPECT_NEAR(sum, 1.0, 1e-9);
+
+    options.tolerance = 1e-5;
+    auto [single, single_status] = pageRank<float>(snapshot, pool, options);
+    ASSERT_TRUE(single_status.isOK());
+    for (size_t v = 0; v < expected.size(); ++v)
+        EXPECT_NEAR(single.ranks[v], expected[v], 1e-5);
+}
+
+TEST(PageRankTest, PersonalizedRanksStayNearSeeds) {
+    GraphList<std::string, int> graph;
+    for (const char *v : {"a", "b", "c", "x", "y"})
+        graph.addVertex(v);
+    graph.addEdge("a", "b");
+    graph.addEdge("b", "c");
+    graph.addEdge("c", "a");
+    graph.addEdge("x", "y");
+    graph.addEdge("y", "x");
+
+    auto uniform = graph.pageRank();
+    EXPECT_NEAR(uniform.ranks[graph.vertexId("a")], 0.2, 1e-6);
+    auto result = graph.personalizedPageRank({"a"});
+    EXPECT_TRUE(result.converged);
+    EXPECT_GT(result.ranks[graph.vertexId("a")],
+              result.ranks[graph.vertexId("b")]);
+    EXPECT_GT(result.ranks[graph.vertexId("b")],
+              result.ranks[graph.vertexId("c")]);
+    EXPECT_EQ(result.ranks[graph.vertexId("x")], 0.0);
+    EXPECT_EQ(result.ranks[graph.vertexId("y")], 0.0);
+
+    Concurrency::ThreadPool pool(2);
+    PageRankOptions bad;
+    bad.damping = 1.0;
+    EXPECT_EQ(pageRank(graph.csrSnapshot(), pool, bad).second.code(),
+              StatusCode::INVALID_ARGUMENT);
+}
+
+TEST(PageRankTest, SparseIdsOfAConcurrentGraphGetNoRank) {
+    // Concurrent graphs shard their ids, leaving gaps without a vertex.
+    GraphList<int, int> sparse(GraphCreationOptions(
+        {GraphCreationOptions::Directed, GraphCreationOptions::Concurrent}));
+    GraphList<int, int> dense(
+        GraphCreationOptions({GraphCreationOptions::Directed}));
+    for (auto *graph : {&sparse, &dense}) {
+        graph->addVertices(std::vector<int>{1, 2, 3, 4});
+        graph->addEdge(1, 2);
+        graph->addEdge(3, 4);
+    }
+    const auto snapshot = sparse.csrSnapshot();
+    ASSERT_GT(snapshot.numVertices(), 4u);
+    EXPECT_EQ(snapshot.vertexCount(), 4u);
+
+    auto expected = dense.pageRank();
+    auto result = sparse.pageRank();
+    ASSERT_TRUE(result.converged);
+    double sum = 0;
+    for (int v : {1, 2, 3, 4}) {
+        EXPECT_NEAR(result.ranks[sparse.vertexId(v)],
+                    expected.ranks[dense.vertexId(v)], 1e-9);
+        sum += result.ranks[sparse.vertexId(v)];
+    }
+    EXPECT_NEAR(sum, 1.0, 1e-9);
+    for (size_t id = 0; id < snapshot.numVertices(); ++id) {
+        if (!snapshot.isVertex(static_cast<VertexId>(id))) {
+            EXPECT_EQ(result.ranks[id], 0.0);
+        }
+    }
+
+    Concurrency::ThreadPool pool(2);
+    std::vector<double> weights(snapshot.numVertices(), 1.0);
+    EXPECT_EQ(pageRank(snapshot, pool, {}, &weights).second.code(),
+              StatusCode::INVALID_ARGUMENT);
+}
+
+//
+// 5. Connected Components
+//
+
+TEST(ComponentsTest, WeakComponentsOnGraphMatrix) {
+    GraphMatrix<std::string, int> graph;
+    for (const char *v : {"a", "b", "c", "x", "y", "z"})
+        graph.addVertex(v);
+    // Edges point against the id order, so only weak connectivity joins them.
+    graph.addEdge("c", "b");
+    graph.addEdge("b", "a");
+    graph.addEdge("y", "x");
+
+    auto result = graph.connectedComponents();
+    ASSERT_EQ(result.sizes.size(), 3u);
+    EXPECT_EQ(result.sizes, (std::vector<size_t>{3, 2, 1}));
+    auto component = [&](const char *v) {
+        return result.components[graph.vertexId(v)];
+    };
+    EXPECT_EQ(component("a"), 0u);
+    EXPECT_EQ(component("c"), 0u);
+    EXPECT_EQ(component("x"), 1u);
+    EXPECT_EQ(component("y"), 1u);
+    EXPECT_EQ(component("z"), 2u);
+}
+
+TEST(ComponentsTest, AfforestMatchesSerialUnionFind) {
+    GraphList<int, int> graph(GraphCreationOptions(
+        {GraphCreationOptions::Directed, GraphCreationOptions::Weighted}));
+    // Sparse enough to leave a giant component and many small ones.
+    load(graph, 6000, randomEdges(6000, 4800, 5));
+    auto snapshot = graph.csrSnapshot();
+    const size_t n = snapshot.numVertices();
+
+    std::vector<VertexId> parent(n);
+    for (VertexId v = 0; v < n; ++v)
+        parent[v] = v;
+    auto find = [&](VertexId v) {
+        while (parent[v] != v)
+            v = parent[v] = parent[parent[v]];
+        return v;
+    };
+    for (VertexId u = 0; u < n; ++u) {
+        for (size_t e = snapshot.offsets()[u]; e < snapshot.offsets()[u + 1];
+             ++e) {
+            VertexId a = find(u), b = find(snapshot.cols()[e]);
+            parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+    std::vector<VertexId> expected(n), label(n, INVALID_VERTEX_ID);
+    std::vector<size_t> expected_sizes;
+    for (VertexId v = 0; v < n; ++v) {
+        VertexId root = find(v);
+        if (label[root] == INVALID_VERTEX_ID) {
+            label[root] = static_cast<VertexId>(expected_sizes.size());
+            expected_sizes.push_back(0);
+        }
+        expected[v] = label[root];
+        ++expected_sizes[label[root]];
+    }
+    ASSERT_GT(*std::max_element(expected_sizes.begin(), expected_sizes.end()),
+              n / 2);
+
+    Concurrency::ThreadPool pool(4);
+    auto scanned = connectedComponents(snapshot, pool);
+    EXPECT_EQ(scanned.components, expected);
+    EXPECT_EQ(scanned.sizes, expected_sizes);
+    EXPECT_EQ(graph.connectedComponents().components, expected);
+
+    // Sampling only runs when the giant component can be skipped: with a
+    // transpose, or on a graph that stores both directions of every edge.
+    auto transpose = snapshot.transposed(pool);
+    GraphList<int, int> both_ways(GraphCreationOptions(
+        {GraphCreationOptions::Directed, GraphCreationOptions::Weighted}));
+    Edges edges = randomEdges(6000, 4800, 5), reversed;
+    for (const auto &[src, dest, weight] : edges)
+        reversed.emplace_back(dest, src, weight);
+    load(both_ways, 6000, edges);
+    both_ways.addEdges(reversed);
+    auto symmetric = both_ways.csrSnapshot();
+    for (size_t rounds : {0, 2, 5}) {
+        ComponentsOptions options;
+        options.neighbor_rounds = rounds;
+        auto sampled = connectedComponents(snapshot, pool, options, &transpose);
+        EXPECT_EQ(sampled.components, expected);
+        EXPECT_EQ(sampled.sizes, expected_sizes);
+        // The wrappers pass a transpose, so they sample as well.
+        EXPECT_EQ(graph.connectedComponents(options).sizes, expected_sizes);
+        options.symmetric = true;
+        EXPECT_EQ(connectedComponents(symmetric, pool, options).components,
+                  expected);
+    }
+}
+
+TEST(ComponentsTest, SparseIdsOfAConcurrentGraphAreNotComponents) {
+    GraphList<int, int> graph(GraphCreationOptions(
+        {GraphCreationOptions::Undirected, GraphCreationOptions::Concurrent}));
+    graph.addVertices(std::vector<int>{1, 2, 3, 4});
+    graph.addEdge(2, 1);
+    graph.addEdge(3, 4);
+    const auto snapshot = graph.csrSnapshot();
+    ASSERT_GT(snapshot.numVertices(), 4u);
+
+    auto result = graph.connectedComponents();
+    EXPECT_EQ(result.sizes, (std::vector<size_t>{2, 2}));
+    EXPECT_EQ(result.components[graph.vertexId(1)],
+              result.components[graph.vertexId(2)]);
+    EXPECT_EQ(result.components[graph.vertexId(3)],
+              result.components[graph.vertexId(4)]);
+    EXPECT_NE(result.components[graph.vertexId(1)],
+              result.components[graph.vertexId(3)]);
+    size_t labelled = 0;
+    for (size_t id = 0; id < snapshot.numVertices(); ++id) {
+        const bool vertex = snapshot.isVertex(static_cast<VertexId>(id));
+        EXPECT_EQ(result.components[id] != INVALID_VERTEX_ID, vertex);
+        labelled += vertex;
+    }
+    EXPECT_EQ(labelled, 4u);
+}
+
+//
+// 6. Triangles
+//
+
+TEST(TriangleTest, IntersectionMatchesSetIntersection) {
+    std::mt19937 rng(3);
+    // Length pairs that hit the block kernel, its tails and galloping.
+    for (auto [na, nb] : {std::pair<int, int>{0, 5}, {3, 3}, {17, 23},
+                          {64, 70}, {200, 190}, {5, 400}, {2, 3000}}) {
+        std::uniform_int_distribution<VertexId> value(0, 3 * (na + nb));
+        auto sortedSet = [&](int size) {
+            std::vector<VertexId> out;
+            for (int i = 0; i < size; ++i)
+                out.push_back(value(rng));
+            std::sort(out.begin(), out.end());
+            out.erase(std::unique(out.begin(), out.end()), out.end());
+            return out;
+        };
+        std::vector<VertexId> a = sortedSet(na), b = sortedSet(nb), expected;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                              std::back_inserter(expected));
+        std::vector<VertexId> found;
+        size_t count = detail::intersectSorted(
+            a.data(), a.size(), b.data(), b.size(),
+            [&](VertexId w) { found.push_back(w); });
+        std::sort(found.begin(), found.end());
+        EXPECT_EQ(count, expected.size());
+        EXPECT_EQ(found, expected);
+    }
+}
+
+TEST(TriangleTest, CountsAndClusteringOnASmallGraph) {
+    GraphList<std::string, int> graph;
+    for (const char *v : {"a", "b", "c", "d", "e"})
+        graph.addVertex(v);
+    // Triangles abc and abd in mixed directions, with a reciprocal edge
+    // and a pendant vertex.
+    graph.addEdge("a", "b");
+    graph.addEdge("b", "a");
+    graph.addEdge("c", "b");
+    graph.addEdge("a", "c");
+    graph.addEdge("d", "a");
+    graph.addEdge("b", "d");
+    graph.addEdge("d", "e");
+
+    auto result = graph.triangles();
+    EXPECT_EQ(result.triangles, 2u);
+    EXPECT_DOUBLE_EQ(result.transitivity, 0.6);
+    auto at = [&](const char *v) { return graph.vertexId(v); };
+    EXPECT_EQ(result.per_vertex[at("a")], 2u);
+    EXPECT_EQ(result.per_vertex[at("c")], 1u);
+    EXPECT_EQ(result.per_vertex[at("e")], 0u);
+    EXPECT_DOUBLE_EQ(result.clustering[at("b")], 2.0 / 3);
+    EXPECT_DOUBLE_EQ(result.clustering[at("c")], 1.0);
+    EXPECT_DOUBLE_EQ(result.clustering[at("d")], 1.0 / 3);
+    EXPECT_DOUBLE_EQ(result.clustering[at("e")], 0.0);
+}
+
+TEST(TriangleTest, MatchesBruteForceCount) {
+    GraphList<int, int> graph(GraphCreationOptions(
+        {GraphCreationOptions::Directed, GraphCreationOptions::Weighted}));
+    Edges edges = randomEdges(800, 16000, 13);
+    // A hub adjacent to every vertex makes rows of very different lengths.
+    for (int v = 1; v < 800; ++v)
+        edges.emplace_back(v % 2 ? 0 : v, v % 2 ? v : 0, 1);
+    load(graph, 800, edges);
+    auto snapshot = graph.csrSnapshot();
+    const size_t n = snapshot.numVertices();
+
+    std::vector<std::vector<bool>> adjacent(n, std::vector<bool>(n, false));
+    for (VertexId u = 0; u < n; ++u) {
+        for (size_t e = snapshot.offsets()[u]; e < snapshot.offsets()[u + 1];
+             ++e) {
+            adjacent[u][snapshot.cols()[e]] = true;
+            adjacent[snapshot.cols()[e]][u] = true;
+        }
+    }
+    std::vector<std::uint64_t> expected(n, 0);
+    std::uint64_t expected_total = 0;
+    for (size_t u = 0; u < n; ++u)
+        for (size_t v = u + 1; v < n; ++v)
+            if (adjacent[u][v])
+                for (size_t w = v + 1; w < n; ++w)
+                    if (adjacent[u][w] && adjacent[v][w]) {
+                        ++expected[u];
+                        ++expected[v];
+                        ++expected[w];
+                        ++expected_total;
+                    }
+
+    Concurrency::ThreadPool pool(4);
+    auto result = countTriangles(snapshot, pool);
+    EXPECT_EQ(result.triangles, expected_total);
+    EXPECT_EQ(result.per_vertex, expected);
+    TriangleOptions totals_only;
+    totals_only.local = false;
+    auto totals = countTriangles(snapshot, pool, totals_only);
+    EXPECT_EQ(totals.triangles, expected_total);
+    EXPECT_TRUE(totals.per_vertex.empty());
+    EXPECT_DOUBLE_EQ(totals.transitivity, result.transitivity);
+
+    std::vector<size_t> offsets(n + 1, 0);
+    std::vector<VertexId> cols;
+    for (size_t u = 0; u < n; ++u) {
+        for (size_t v = 0; v < n; ++v)
+            if (adjacent[u][v] && u != v)
+                cols.push_back(static_cast<VertexId>(v));
+        offsets[u + 1] = cols.size();
+    }
+    TriangleOptions symmetric;
+    symmetric.symmetric = true;
+    auto both_ways = countTriangles(
+        CsrSnapshot<int>(offsets, cols), pool, symmetric);
+    EXPECT_EQ(both_ways.per_vertex, expected);
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "Concurrency/ThreadPool.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace CinderPeak::Concurrency;
+
+//
+// 1. Parallel Loops
+//
+
+TEST(ThreadPoolTest, ParallelForCoversRangeOnce) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> hits(10000);
+    std::atomic<size_t> chunks{0};
+    pool.parallel_for(0, hits.size(), [&](size_t lo, size_t hi) {
+        chunks++;
+        for (size_t i = lo; i < hi; ++i)
+            hits[i]++;
+    }, 100);
+    for (const auto &hit : hits)
+        ASSERT_EQ(hit.load(), 1);
+    EXPECT_GE(chunks.load(), 100);
+}
+
+TEST(ThreadPoolTest, WeightedSplitIsolatesHeavyItems) {
+    ThreadPool pool(4);
+    // Item 10 weighs as much as the other 99 together.
+    std::vector<size_t> prefix(101, 0);
+    for (size_t i = 0; i < 100; ++i)
+        prefix[i + 1] = prefix[i] + (i == 10 ? 99 : 1);
+    std::atomic<size_t> covered{0};
+    std::atomic<bool> heavy_alone{false};
+    pool.parallel_for_weighted(0, 100, [&](size_t i) { return prefix[i]; },
+                               [&](size_t lo, size_t hi) {
+                                   covered += hi - lo;
+                                   if (lo == 10 && hi == 11)
+                                       heavy_alone = true;
+                                   EXPECT_TRUE(hi - lo == 1 || prefix[hi] - prefix[lo] <= 16);
+                               }, 16);
+    EXPECT_EQ(covered.load(), 100);
+    EXPECT_TRUE(heavy_alone.load());
+}
+
+TEST(ThreadPoolTest, SingleThreadPoolRunsInline) {
+    ThreadPool pool(1);
+    size_t calls = 0;
+    pool.parallel_for(0, 1000, [&](size_t lo, size_t hi) {
+        calls++;
+        EXPECT_EQ(lo, 0);
+        EXPECT_EQ(hi, 1000);
+    });
+    EXPECT_EQ(calls, 1);
+}
+
+//
+// 2. Fork/Join
+//
+
+namespace {
+long fib(ThreadPool &pool, int n) {
+    if (n < 12)
+        return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    long a = 0, b = 0;
+    pool.fork_join([&] { a = fib(pool, n - 1); }, [&] { b = fib(pool, n - 2); });
+    return a + b;
+}
+}
+
+TEST(ThreadPoolTest, NestedForkJoin) {
+    ThreadPool pool(4);
+    EXPECT_EQ(fib(pool, 22), 17711);
+}
+
+TEST(ThreadPoolTest, TaskExceptionsReachTheWaiter) {
+    ThreadPool pool(2);
+    EXPECT_THROW(pool.parallel_for(0, 64, [](size_t lo, size_t) {
+        if (lo == 0)
+            throw std::runtime_error("boom");
+    }, 1), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, GlobalHandleCanBeResized) {
+    ThreadPool::setGlobalThreads(3);
+    auto pool = ThreadPool::global();
+    EXPECT_EQ(pool->size(), 3);
+    ThreadPool::setGlobalThreads(2);
+    EXPECT_EQ(ThreadPool::global()->size(), 2);
+    // Handles taken before the switch stay usable.
+    std::atomic<int> sum{0};
+    pool->parallel_for(0, 10, [&](size_t lo, size_t hi) { sum += static_cast<int>(hi - lo); }, 1);
+    EXPECT_EQ(sum.load(), 10);
+}
@@ -0,0 +1,335 @@
+#include <gtest/gtest.h>
+#include "StorageEngine/HybridCSR_COO.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace CinderPeak;
+using namespace PeakStore;
+
+class HybridCSRTest : public ::testing::Test {
+protected:
+    HybridCSR_COO<int, int> graph;
+
+    void SetUp() override {
+        for (int v = 1; v <= 5; ++v)
+            graph.impl_addVertex(v);
+    }
+};
+
+//
+// 1. Build and Lookup
+//
+
+TEST_F(HybridCSRTest, ReadsDoNotBuild) {
+    EXPECT_TRUE(graph.impl_addEdge(1, 3, 13).isOK());
+    EXPECT_TRUE(graph.impl_addEdge(1, 2, 12).isOK());
+    EXPECT_EQ(graph.pendingEdges(), 2);
+
+    auto edge = graph.impl_getEdge(1, 2);
+    EXPECT_TRUE(edge.second.isOK());
+    EXPECT_EQ(edge.first, 12);
+    EXPECT_EQ(graph.pendingEdges(), 2);
+    graph.flush();
+    EXPECT_EQ(graph.pendingEdges(), 0);
+    EXPECT_EQ(graph.impl_getEdge(1, 3).first, 13);
+}
+
+TEST_F(HybridCSRTest, MissingEdgeAndVertex) {
+    graph.impl_addEdge(1, 2, 12);
+    EXPECT_EQ(graph.impl_getEdge(2, 1).second.code(), StatusCode::EDGE_NOT_FOUND);
+    EXPECT_EQ(graph.impl_getEdge(99, 1).second.code(), StatusCode::VERTEX_NOT_FOUND);
+    EXPECT_EQ(graph.impl_addEdge(1, 99).code(), StatusCode::VERTEX_NOT_FOUND);
+}
+
+//
+// 2. Delta Store
+//
+
+TEST_F(HybridCSRTest, EdgesAfterBuildAreStaged) {
+    graph.impl_addEdge(1, 2, 12);
+    graph.flush();
+
+    EXPECT_TRUE(graph.impl_addEdge(3, 4, 34).isOK());
+    EXPECT_TRUE(graph.impl_addEdge(1, 5, 15).isOK());
+    EXPECT_EQ(graph.pendingEdges(), 2);
+
+    EXPECT_EQ(graph.impl_getEdge(3, 4).first, 34);
+    EXPECT_EQ(graph.impl_getEdge(1, 5).first, 15);
+    EXPECT_EQ(graph.impl_getEdge(1, 2).first, 12);
+    EXPECT_TRUE(graph.impl_doesEdgeExist(3, 4));
+    EXPECT_EQ(graph.pendingEdges(), 2);
+}
+
+TEST_F(HybridCSRTest, FlushMergesDelta) {
+    graph.impl_addEdge(2, 5, 25);
+    graph.flush();
+    graph.impl_addEdge(2, 3, 23);
+    graph.impl_addEdge(2, 4, 24);
+    graph.impl_addVertex(6);
+    graph.impl_addEdge(6, 2, 62);
+
+    graph.flush();
+    EXPECT_EQ(graph.pendingEdges(), 0);
+    EXPECT_EQ(graph.impl_getEdge(2, 3).first, 23);
+    EXPECT_EQ(graph.impl_getEdge(2, 4).first, 24);
+    EXPECT_EQ(graph.impl_getEdge(2, 5).first, 25);
+    EXPECT_EQ(graph.impl_getEdge(6, 2).first, 62);
+}
+
+TEST_F(HybridCSRTest, ThresholdTriggersMerge) {
+    graph.flush();
+    graph.setDeltaThreshold(3, 0.0);
+
+    graph.impl_addEdge(1, 2, 12);
+    graph.impl_addEdge(4, 1, 41);
+    EXPECT_EQ(graph.pendingEdges(), 2);
+
+    graph.impl_addEdge(3, 3, 33);
+    EXPECT_EQ(graph.pendingEdges(), 0);
+    EXPECT_EQ(graph.impl_getEdge(1, 2).first, 12);
+    EXPECT_EQ(graph.impl_getEdge(4, 1).first, 41);
+    EXPECT_EQ(graph.impl_getEdge(3, 3).first, 33);
+}
+
+TEST_F(HybridCSRTest, ThresholdMergesAreTimed) {
+    auto stats = std::make_shared<StoreStats>();
+    HybridCSR_COO<int, int> timed(nullptr, nullptr, stats);
+    for (int v = 1; v <= 3; ++v)
+        timed.impl_addVertex(v);
+    timed.setDeltaThreshold(2, 0.0);
+    timed.impl_addEdge(1, 2, 12);
+    EXPECT_EQ(stats->summary(StoreOp::CsrRebuild).count, 0);
+    timed.impl_addEdge(2, 3, 23);
+    EXPECT_EQ(timed.pendingEdges(), 0);
+    EXPECT_EQ(stats->summary(StoreOp::CsrRebuild).count, 1);
+}
+
+//
+// 3. Bulk Construction
+//
+
+TEST_F(HybridCSRTest, BulkBuildSortsRows) {
+    auto [added, status] = graph.impl_addEdges({{1, 5, 15}, {1, 2, 12}, {3, 1, 31}, {1, 4, 14}});
+    EXPECT_TRUE(status.isOK());
+    EXPECT_EQ(added, 4);
+    EXPECT_EQ(graph.pendingEdges(), 0);
+    EXPECT_EQ(graph.impl_getEdge(1, 2).first, 12);
+    EXPECT_EQ(graph.impl_getEdge(1, 4).first, 14);
+    EXPECT_EQ(graph.impl_getEdge(1, 5).first, 15);
+    EXPECT_EQ(graph.impl_getEdge(3, 1).first, 31);
+}
+
+TEST_F(HybridCSRTest, BulkAfterBuildGoesToDelta) {
+    graph.impl_addEdges({{1, 2, 12}});
+    graph.impl_addEdges({{2, 3, 23}, {1, 3, 13}});
+    EXPECT_EQ(graph.pendingEdges(), 2);
+    EXPECT_EQ(graph.impl_getEdge(2, 3).first, 23);
+    EXPECT_EQ(graph.impl_getEdge(1, 3).first, 13);
+    EXPECT_EQ(graph.impl_addEdges({{1, 99, 0}}).second.code(), StatusCode::VERTEX_NOT_FOUND);
+}
+
+TEST_F(HybridCSRTest, NeighborsIncludeStagedEdges) {
+    graph.impl_addEdges({{1, 3, 13}, {1, 2, 12}});
+    graph.impl_addEdge(1, 5, 15);
+
+    auto neighbors = graph.impl_getNeighbors(1);
+    ASSERT_TRUE(neighbors.second.isOK());
+    ASSERT_EQ(neighbors.first.size(), 3);
+    EXPECT_EQ(neighbors.first[0].first, 2);
+    EXPECT_EQ(neighbors.first[1].first, 3);
+    EXPECT_EQ(neighbors.first[2].first, 5);
+    EXPECT_EQ(graph.impl_getNeighbors(42).second.code(), StatusCode::VERTEX_NOT_FOUND);
+}
+
+TEST_F(HybridCSRTest, InsertEdgeUpdatesCSRAndDelta) {
+    graph.impl_addEdges({{1, 2, 12}});
+    EXPECT_EQ(graph.impl_insertEdge(1, 2, 21, EdgeInsertMode::Upsert).first,
+              EdgeInsertResult::Updated);
+    EXPECT_EQ(graph.impl_insertEdge(1, 3, 13, EdgeInsertMode::InsertIfAbsent).first,
+              EdgeInsertResult::Inserted);
+    EXPECT_EQ(graph.impl_insertEdge(1, 3, 31, EdgeInsertMode::InsertIfAbsent).first,
+              EdgeInsertResult::Existing);
+    EXPECT_EQ(graph.impl_insertEdge(1, 3, 31, EdgeInsertMode::Upsert).first,
+              EdgeInsertResult::Updated);
+
+    EXPECT_EQ(graph.pendingEdges(), 1);
+    EXPECT_EQ(graph.impl_getEdge(1, 2).first, 21);
+    EXPECT_EQ(graph.impl_getEdge(1, 3).first, 31);
+
+    EXPECT_EQ(graph.impl_insertEdge(1, 2, 22, EdgeInsertMode::AllowParallel).first,
+              EdgeInsertResult::InsertedParallel);
+    EXPECT_EQ(graph.impl_insertEdge(1, 4, 14, EdgeInsertMode::AllowParallel).first,
+              EdgeInsertResult::Inserted);
+    size_t parallel = 0;
+    graph.impl_addEdges({{1, 3, 32}, {1, 5, 15}, {1, 5, 51}}, &parallel);
+    EXPECT_EQ(parallel, 2);
+}
+
+TEST_F(HybridCSRTest, WeightUpdatesArePatched) {
+    graph.impl_addEdges({{1, 2, 12}, {1, 4, 14}, {2, 3, 23}});
+    graph.impl_addEdge(1, 3, 13);
+    auto before = graph.impl_neighbors(1).first;
+    EXPECT_EQ(graph.impl_insertEdge(1, 4, 41, EdgeInsertMode::Upsert).first,
+              EdgeInsertResult::Updated);
+    EXPECT_EQ(graph.impl_insertEdge(1, 3, 31, EdgeInsertMode::Upsert).first,
+              EdgeInsertResult::Updated);
+    graph.impl_addEdge(1, 5, 15);
+    EXPECT_EQ(graph.pendingEdges(), 2);
+
+    // The CSR row and the staged edges stay where they were; only the
+    // weights change, and not for views taken earlier.
+    auto collect = [](const auto &view) {
+        std::vector<std::pair<int, int>> row;
+        for (const auto &[dest, weight] : view)
+            row.emplace_back(dest, weight);
+        return row;
+    };
+    EXPECT_EQ(collect(graph.impl_neighbors(1).first),
+              (std::vector<std::pair<int, int>>{{2, 12}, {4, 41}, {3, 31}, {5, 15}}));
+    EXPECT_EQ(collect(before),
+              (std::vector<std::pair<int, int>>{{2, 12}, {4, 14}, {3, 13}}));
+    EXPECT_EQ(graph.impl_getEdge(1, 4).first, 41);
+    EXPECT_EQ(graph.impl_getEdge(2, 3).first, 23);
+
+    graph.flush();
+    EXPECT_EQ(graph.pendingEdges(), 0);
+    EXPECT_EQ(collect(graph.impl_neighbors(1).first),
+              (std::vector<std::pair<int, int>>{{2, 12}, {3, 31}, {4, 41}, {5, 15}}));
+}
+
+TEST_F(HybridCSRTest, HubRowAppendsStaySearchable) {
+    constexpr int fanout = 400;
+    for (int v = 100; v < 100 + fanout; ++v)
+        graph.impl_addVertex(v);
+    graph.impl_addEdges({{1, 2, 12}});
+    graph.setDeltaThreshold(1 << 20, 0.0);
+    NeighborView<int, int> half;
+    // Descending destinations keep every append out of order, so the row's
+    // unsorted tail is sorted in several times on the way.
+    for (int i = 0; i < fanout; ++i) {
+        const int dest = 100 + fanout - 1 - i;
+        EXPECT_EQ(graph.impl_insertEdge(1, dest, dest, EdgeInsertMode::InsertIfAbsent).first,
+                  EdgeInsertResult::Inserted);
+        if (i == fanout / 2)
+            half = graph.impl_neighbors(1).first;
+    }
+    EXPECT_EQ(graph.pendingEdges(), fanout);
+    for (int dest = 100; dest < 100 + fanout; dest += 7) {
+        EXPECT_EQ(graph.impl_insertEdge(1, dest, -dest, EdgeInsertMode::Upsert).first,
+                  EdgeInsertResult::Updated);
+    }
+    graph.impl_addEdge(1, 100, 1);
+    for (int dest = 100; dest < 100 + fanout; ++dest)
+        EXPECT_EQ(graph.impl_getEdge(1, dest).first, (dest - 100) % 7 ? dest : -dest);
+    EXPECT_EQ(half.size(), fanout / 2 + 2);
+
+    graph.flush();
+    std::vector<int> dests;
+    auto merged = graph.impl_neighbors(1).first;
+    for (auto it = merged.begin(); it != merged.end(); ++it)
+        dests.push_back(it.vertex());
+    EXPECT_EQ(dests.size(), fanout + 2);
+    EXPECT_TRUE(std::is_sorted(dests.begin(), dests.end()));
+    // The parallel edge comes after the updated one.
+    EXPECT_EQ(graph.impl_getEdge(1, 100).first, -100);
+}
+
+TEST_F(HybridCSRTest, ViewSpansCSRRowAndDelta) {
+    graph.impl_addEdges({{1, 4, 14}, {1, 2, 12}, {2, 3, 23}});
+    graph.impl_addEdge(1, 3, 13);
+    graph.impl_addEdge(1, 5, 15);
+    ASSERT_EQ(graph.pendingEdges(), 2);
+
+    auto [view, status] = graph.impl_neighbors(1);
+    ASSERT_TRUE(status.isOK());
+    EXPECT_EQ(view.size(), 4);
+    std::vector<int> ids;
+    for (auto it = view.begin(); it != view.end(); ++it) {
+        EXPECT_EQ(it.weight(), 10 + it.vertex());
+        ids.push_back(it.vertex());
+    }
+    // CSR row first, then the staged edges.
+    EXPECT_EQ(ids, (std::vector<int>{2, 4, 3, 5}));
+    EXPECT_TRUE(graph.impl_neighbors(5).first.empty());
+}
+
+TEST_F(HybridCSRTest, LargeBuildMatchesInput) {
+    HybridCSR_COO<int, int> large;
+    constexpr int vertices = 512;
+    for (int v = 0; v < vertices; ++v)
+        large.impl_addVertex(v);
+    // Large enough to be split across workers on multi-core machines. Every
+    // (src, dest) pair appears twice, with the first copy weighted lower.
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < (1 << 17); ++i) {
+            const int src = (i * 7919) % vertices;
+            const int dest = (i / vertices * 31 + i) % vertices;
+            edges.emplace_back(src, dest, round * (1 << 20) + i);
+        }
+    }
+    ASSERT_TRUE(large.impl_addEdges(edges).second.isOK());
+    EXPECT_EQ(large.pendingEdges(), 0);
+
+    size_t total = 0;
+    for (int v = 0; v < vertices; ++v) {
+        auto [view, status] = large.impl_neighbors(v);
+        int prev_dest = -1;
+        int prev_weight = -1;
+        for (auto it = view.begin(); it != view.end(); ++it, ++total) {
+            ASSERT_LE(prev_dest, it.vertex());
+            if (prev_dest == it.vertex()) {
+                EXPECT_LT(prev_weight, it.weight());
+            }
+            prev_dest = it.vertex();
+            prev_weight = it.weight();
+        }
+    }
+    EXPECT_EQ(total, edges.size());
+    EXPECT_EQ(large.impl_getEdge(7919 % vertices, 1).first, 1);
+}
+
+//
+// 4. Snapshots
+//
+
+TEST_F(HybridCSRTest, ReadersRunAlongsideWriter) {
+    // Vertex insertions may only overlap reads on a concurrent dictionary.
+    HybridCSR_COO<int, int> shared(std::make_shared<VertexDictionary<int>>(true));
+    for (int v = 1; v <= 3; ++v)
+        shared.impl_addVertex(v);
+    shared.impl_addEdges({{1, 2, 12}, {3, 1, -99}});
+    shared.setDeltaThreshold(8, 0.0);
+    auto held = shared.impl_neighbors(3).first;
+    std::atomic<bool> stop{false};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                // Every generation keeps the first edge.
+                EXPECT_EQ(shared.impl_getEdge(1, 2).first, 12);
+                auto view = shared.impl_neighbors(3).first;
+                for (auto it = view.begin(); it != view.end(); ++it)
+                    EXPECT_EQ(it.weight(), it.vertex() - 100);
+            }
+        });
+    }
+    for (int i = 0; i < 500; ++i) {
+        shared.impl_addVertex(100 + i);
+        shared.impl_addEdge(3, 100 + i, i);
+        // Patches the weight of row 3's CSR edge.
+        shared.impl_insertEdge(3, 1, -99, EdgeInsertMode::Upsert);
+    }
+    stop = true;
+    for (auto &reader : readers)
+        reader.join();
+
+    // A view taken before the writes still reads its own generation.
+    ASSERT_EQ(held.size(), 1);
+    EXPECT_EQ(held.begin().weight(), -99);
+    EXPECT_EQ(shared.impl_getNeighbors(3).first.size(), 501);
+    EXPECT_EQ(shared.impl_getEdge(3, 599).first, 499);
+}
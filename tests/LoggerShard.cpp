@@ -0,0 +1,123 @@
+// TRACE is compiled out for this file; see LevelFiltering below.
+#define CINDERPEAK_LOG_LEVEL 1
+#include <gtest/gtest.h>
+#include "PeakLogger.hpp"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+size_t countLines(const std::string &path) {
+    std::ifstream in(path);
+    size_t lines = 0;
+    for (std::string line; std::getline(in, line);)
+        ++lines;
+    return lines;
+}
+
+class AsyncLoggerTest : public ::testing::Test {
+protected:
+    const std::string path = ::testing::TempDir() + "cinderpeak_async.log";
+
+    void SetUp() override {
+        std::remove(path.c_str());
+        Logger::logFileName = path;
+        Logger::enableConsoleLogging = false;
+        Logger::enableFileLogging = true;
+    }
+    void TearDown() override {
+        Logger::shutdown();
+        Logger::enableFileLogging = false;
+        std::remove(path.c_str());
+    }
+
+    void logFromThreads(int threads, int per_thread) {
+        std::vector<std::thread> writers;
+        for (int t = 0; t < threads; ++t) {
+            writers.emplace_back([t, per_thread] {
+                for (int i = 0; i < per_thread; ++i)
+                    LOG_WARNING("writer " + std::to_string(t) + " line " + std::to_string(i));
+            });
+        }
+        for (auto &writer : writers)
+            writer.join();
+    }
+};
+
+} // namespace
+
+//
+// 1. Async Mode
+//
+
+TEST_F(AsyncLoggerTest, BlockingModeWritesEveryRecordBeforeShutdown) {
+    Logger::enableAsync(16, LogOverflow::Block);
+    EXPECT_TRUE(Logger::isAsync());
+    logFromThreads(4, 500);
+    Logger::log(LogLevel::INFO, "plain", std::string("caller.cpp"), 7);
+    Logger::shutdown();
+    EXPECT_FALSE(Logger::isAsync());
+    EXPECT_EQ(countLines(path), 2001);
+
+    std::ifstream in(path);
+    std::string line, last;
+    while (std::getline(in, line))
+        last = line;
+    EXPECT_NE(last.find("[INFO] plain (caller.cpp:7)"), std::string::npos);
+}
+
+TEST_F(AsyncLoggerTest, DropModeAccountsForEveryRecord) {
+    const size_t dropped_before = Logger::droppedRecords();
+    Logger::enableAsync(2, LogOverflow::Drop);
+    logFromThreads(4, 500);
+    Logger::disableAsync();
+    Logger::shutdown();
+    EXPECT_EQ(countLines(path) + Logger::droppedRecords() - dropped_before, 2000);
+}
+
+TEST_F(AsyncLoggerTest, SynchronousAfterDisable) {
+    Logger::enableAsync();
+    Logger::disableAsync();
+    LOG_ERROR("direct");
+    Logger::shutdown();
+    EXPECT_EQ(countLines(path), 1);
+}
+
+//
+// 2. Level Filtering
+//
+
+TEST(LogFormatTest, SubstitutesPlaceholdersInOrder) {
+    EXPECT_EQ(Logger::format("edge {} -> {} ({})", 1, "b", 2.5), "edge 1 -> b (2.5)");
+    EXPECT_EQ(Logger::format("no args {}"), "no args {}");
+    EXPECT_EQ(Logger::format("{} only", 1, 2), "1 only");
+    EXPECT_EQ(Logger::format("{} and {}", 1), "1 and {}");
+}
+
+TEST_F(AsyncLoggerTest, LevelFiltering) {
+    int evaluated = 0;
+    auto count = [&evaluated] { return ++evaluated; };
+
+    LOG_TRACE("compiled out {}", count());
+    EXPECT_EQ(evaluated, 0);
+
+    Logger::minLevel = LogLevel::WARNING;
+    LOG_DEBUG("below the runtime level {}", count());
+    EXPECT_EQ(evaluated, 0);
+    LOG_ERROR("kept {}", count());
+    EXPECT_EQ(evaluated, 1);
+    Logger::minLevel = LogLevel::TRACE;
+
+    Logger::enableFileLogging = false;
+    LOG_CRITICAL("logging disabled {}", count());
+    EXPECT_EQ(evaluated, 1);
+    Logger::enableFileLogging = true;
+    LOG_DEBUG("debug {}", count());
+    EXPECT_EQ(evaluated, 2);
+
+    Logger::shutdown();
+    EXPECT_EQ(countLines(path), 2);
+}
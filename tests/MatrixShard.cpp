@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "StorageEngine/AdjacencyMatrix.hpp"
+
+using namespace CinderPeak;
+using namespace PeakStore;
+
+class AdjacencyMatrixTest : public ::testing::Test {
+protected:
+    AdjacencyMatrix<int, int> weighted;
+    AdjacencyMatrix<int, int> unweighted{nullptr, false};
+
+    void SetUp() override {
+        for (int v = 0; v < 4; ++v) {
+            weighted.impl_addVertex(v);
+            unweighted.impl_addVertex(v);
+        }
+    }
+};
+
+//
+// 1. Vertex and Edge Operations
+//
+
+TEST_F(AdjacencyMatrixTest, AddVertexTwice) {
+    EXPECT_EQ(weighted.impl_addVertex(1).code(), StatusCode::VERTEX_ALREADY_EXISTS);
+}
+
+TEST_F(AdjacencyMatrixTest, WeightedEdges) {
+    EXPECT_TRUE(weighted.impl_addEdge(0, 3, 7).isOK());
+    EXPECT_EQ(weighted.impl_getEdge(0, 3).first, 7);
+    EXPECT_EQ(weighted.impl_getEdge(3, 0).second.code(), StatusCode::EDGE_NOT_FOUND);
+    EXPECT_EQ(weighted.impl_getEdge(0, 9).second.code(), StatusCode::VERTEX_NOT_FOUND);
+
+    // Re-adding an edge overwrites its weight.
+    EXPECT_TRUE(weighted.impl_addEdge(0, 3, 8).isOK());
+    EXPECT_EQ(weighted.impl_getEdge(0, 3).first, 8);
+    EXPECT_TRUE(weighted.impl_doesEdgeExist(0, 3, 8));
+    EXPECT_FALSE(weighted.impl_doesEdgeExist(0, 3, 7));
+}
+
+TEST_F(AdjacencyMatrixTest, UnweightedEdges) {
+    EXPECT_TRUE(unweighted.impl_addEdge(1, 2).isOK());
+    EXPECT_TRUE(unweighted.impl_doesEdgeExist(1, 2));
+    EXPECT_FALSE(unweighted.impl_doesEdgeExist(2, 1));
+    EXPECT_EQ(unweighted.impl_getEdge(1, 2).first, 0);
+}
+
+//
+// 2. Growth Across Blocks
+//
+
+TEST_F(AdjacencyMatrixTest, GrowsAcrossBlocks) {
+    const int n = 3 * AdjacencyMatrix<int, int>::BLOCK_DIM + 5;
+    for (int v = 4; v < n; ++v)
+        weighted.impl_addVertex(v);
+    weighted.impl_addEdge(0, 1, 1);
+    weighted.impl_addEdge(0, n - 1, 2);
+    weighted.impl_addEdge(n - 1, 70, 3);
+
+    // Vertices added after edges exist keep those edges intact.
+    weighted.impl_addVertex(n);
+    weighted.impl_addEdge(n, 0, 4);
+
+    EXPECT_EQ(weighted.impl_getEdge(0, 1).first, 1);
+    EXPECT_EQ(weighted.impl_getEdge(0, n - 1).first, 2);
+    EXPECT_EQ(weighted.impl_getEdge(n - 1, 70).first, 3);
+    EXPECT_EQ(weighted.impl_getEdge(n, 0).first, 4);
+
+    auto neighbors = weighted.impl_getNeighbors(0);
+    ASSERT_TRUE(neighbors.second.isOK());
+    ASSERT_EQ(neighbors.first.size(), 2);
+    EXPECT_EQ(neighbors.first[0].first, 1);
+    EXPECT_EQ(neighbors.first[1].first, n - 1);
+}
+
+TEST(AdjacencyMatrixCustomTest, NonTrivialEdgeType) {
+    AdjacencyMatrix<std::string, std::string> graph;
+    graph.impl_addVertex("A");
+    graph.impl_addVertex("B");
+    graph.impl_addEdge("A", "B", "road");
+    graph.impl_addEdge("A", "B", "rail");
+    EXPECT_EQ(graph.impl_getEdge("A", "B").first, "rail");
+}
+
+namespace {
+// Counts live instances; copies made while `fail` is set throw.
+struct FragileWeight {
+    static inline int live = 0;
+    static inline bool fail = false;
+    FragileWeight() { ++live; }
+    FragileWeight(const FragileWeight &) {
+        if (fail)
+            throw std::runtime_error("copy failed");
+        ++live;
+    }
+    FragileWeight &operator=(const FragileWeight &) = default;
+    ~FragileWeight() { --live; }
+};
+} // namespace
+
+TEST(AdjacencyMatrixCustomTest, ThrowingWeightLeavesBlockUnchanged) {
+    {
+        MatrixBlock<FragileWeight> block(true);
+        FragileWeight weight;
+        FragileWeight::fail = true;
+        EXPECT_THROW(block.set(1, 2, weight), std::runtime_error);
+        FragileWeight::fail = false;
+        EXPECT_FALSE(block.test(1, 2));
+        EXPECT_FALSE(block.set(3, 4, weight));
+        EXPECT_EQ(FragileWeight::live, 2);
+    }
+    EXPECT_EQ(FragileWeight::live, 0);
+}
+
+TEST(AdjacencyMatrixInsertTest, ParallelInsertUpdatesInPlace) {
+    AdjacencyMatrix<int, int> graph;
+    graph.impl_addVertex(0);
+    graph.impl_addVertex(1);
+    EXPECT_EQ(graph.impl_insertEdge(0, 1, 1, EdgeInsertMode::InsertIfAbsent).first,
+              EdgeInsertResult::Inserted);
+    EXPECT_EQ(graph.impl_insertEdge(0, 1, 2, EdgeInsertMode::InsertIfAbsent).first,
+              EdgeInsertResult::Existing);
+    EXPECT_EQ(graph.impl_insertEdge(0, 1, 3, EdgeInsertMode::AllowParallel).first,
+              EdgeInsertResult::Updated);
+    EXPECT_EQ(graph.impl_getEdge(0, 1).first, 3);
+}
+
+TEST(AdjacencyMatrixViewTest, ViewWalksBitsAcrossBlocks) {
+    const int n = 3 * AdjacencyMatrix<int, int>::BLOCK_DIM;
+    AdjacencyMatrix<int, int> graph(nullptr, false);
+    for (int v = 0; v < n; ++v)
+        graph.impl_addVertex(v);
+    graph.impl_addEdge(1, n - 1);
+    graph.impl_addEdge(1, 2);
+    graph.impl_addEdge(1, 64);
+
+    auto [view, status] = graph.impl_neighbors(1);
+    ASSERT_TRUE(status.isOK());
+    EXPECT_EQ(view.size(), 3);
+    std::vector<int> ids;
+    for (auto [vertex, weight] : view) {
+        EXPECT_EQ(weight, 0);
+        ids.push_back(vertex);
+    }
+    EXPECT_EQ(ids, (std::vector<int>{2, 64, n - 1}));
+    EXPECT_TRUE(graph.impl_neighbors(2).first.empty());
+}
@@ -0,0 +1,551 @@
+#include <gtest/gtest.h>
+#include "PeakStore.hpp"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace CinderPeak;
+using namespace PeakStore;
+
+namespace {
+GraphInternalMetadata listMetadata() {
+    return GraphInternalMetadata("graph_list", true, true);
+}
+}
+
+//
+// 1. Bulk Loading
+//
+
+TEST(PeakStoreBulkTest, AddVerticesCountsNewOnly) {
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata());
+    store.addVertex(1);
+    EXPECT_TRUE(store.addVertices(std::vector<int>{1, 2, 3}).isOK());
+    EXPECT_EQ(store.getContext()->metadata->num_vertices, 3);
+}
+
+TEST(PeakStoreBulkTest, AddEdgesDropsDuplicatesAndSelfLoops) {
+    GraphCreationOptions opts({GraphCreationOptions::Directed, GraphCreationOptions::Weighted});
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata(), opts);
+    store.addVertices(std::vector<int>{1, 2, 3});
+    store.addEdge(1, 2, 12);
+
+    std::vector<std::tuple<int, int, int>> edges{{1, 2, 99}, {2, 3, 23}, {2, 3, 24}, {3, 3, 33}};
+    EXPECT_TRUE(store.addEdges(edges).isOK());
+    EXPECT_EQ(store.getContext()->metadata->num_edges, 2);
+    EXPECT_EQ(store.getEdge(1, 2).first, 12);
+    EXPECT_EQ(store.getEdge(2, 3).first, 23);
+    EXPECT_FALSE(store.getEdge(3, 3).second.isOK());
+}
+
+TEST(PeakStoreBulkTest, AddEdgesKeepsParallelEdgesWhenAllowed) {
+    GraphCreationOptions opts({GraphCreationOptions::Directed, GraphCreationOptions::ParallelEdges,
+                               GraphCreationOptions::SelfLoops});
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata(), opts);
+    store.addVertices(std::vector<int>{1, 2});
+
+    std::vector<std::pair<int, int>> edges{{1, 2}, {1, 2}, {2, 2}};
+    EXPECT_TRUE(store.addEdges(edges).isOK());
+    EXPECT_EQ(store.getContext()->metadata->num_edges, 3);
+}
+
+//
+// 2. Adaptive Storage
+//
+
+namespace {
+AdaptiveStoragePolicy eagerPolicy() {
+    AdaptiveStoragePolicy policy;
+    policy.window = 16;
+    policy.min_edges = 8;
+    policy.min_vertices = 8;
+    return policy;
+}
+}
+
+TEST(PeakStoreAdaptiveTest, ReadMostlyMigratesToCSRAndBack) {
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata());
+    store.setAdaptivePolicy(eagerPolicy());
+    std::vector<int> vertices;
+    for (int v = 0; v < 32; ++v)
+        vertices.push_back(v);
+    store.addVertices(vertices);
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int v = 0; v < 31; ++v)
+        edges.emplace_back(v, v + 1, v * 10);
+    store.addEdges(edges);
+    EXPECT_EQ(store.activeStorageKind(), StorageKind::AdjacencyList);
+
+    for (int i = 0; i < 64; ++i)
+        store.getEdge(i % 31, i % 31 + 1);
+    // Reads only count themselves; the switch waits for maintain().
+    store.waitForMigration();
+    EXPECT_EQ(store.activeStorageKind(), StorageKind::AdjacencyList);
+    store.maintain();
+    store.waitForMigration();
+    EXPECT_EQ(store.activeStorageKind(), StorageKind::HybridCSR);
+    EXPECT_EQ(store.getEdge(7, 8).first, 70);
+    EXPECT_EQ(store.getNeighbors(30).first.size(), 1);
+
+    for (int v = 32; v < 64; ++v)
+        store.addVertex(v);
+    for (int v = 32; v < 63; ++v)
+        store.addEdge(v, v + 1, v * 10);
+    store.waitForMigration();
+    EXPECT_EQ(store.activeStorageKind(), StorageKind::AdjacencyList);
+    EXPECT_EQ(store.getEdge(7, 8).first, 70);
+    EXPECT_EQ(store.getEdge(40, 41).first, 400);
+    EXPECT_EQ(store.getContext()->metadata->num_edges, 62);
+}
+
+TEST(PeakStoreAdaptiveTest, WritesDuringMigrationAreKept) {
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata());
+    store.setAdaptivePolicy(eagerPolicy());
+    std::vector<int> vertices;
+    for (int v = 0; v < 5000; ++v)
+        vertices.push_back(v);
+    store.addVertices(vertices);
+    std::vector<std::tuple<int, int, int>> edges;
+    for (int v = 0; v < 4999; ++v)
+        edges.emplace_back(v, v + 1, v);
+    store.addEdges(edges);
+
+    for (int i = 0; i < 16; ++i)
+        store.getEdge(i, i + 1);
+    store.maintain();
+    // A migration may now be in flight; these writes race with the builder.
+    store.addVertex(5000);
+    store.addEdge(0, 4999, 1);
+    store.addEdge(4999, 5000, 2);
+    store.waitForMigration();
+
+    EXPECT_EQ(store.getEdge(0, 4999).first, 1);
+    EXPECT_EQ(store.getEdge(4999, 5000).first, 2);
+    EXPECT_EQ(store.getEdge(2500, 2501).first, 2500);
+}
+
+TEST(PeakStoreAdaptiveTest, SparseGraphsStayOnTheList) {
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata());
+    AdaptiveStoragePolicy policy = eagerPolicy();
+    policy.min_density = 0.1;
+    store.setAdaptivePolicy(policy);
+    for (int v = 0; v < 32; ++v)
+        store.addVertex(v);
+    // 31 of 992 possible edges.
+    for (int v = 0; v < 31; ++v)
+        store.addEdge(v, v + 1, v);
+    for (int i = 0; i < 64; ++i)
+        store.getEdge(i % 31, i % 31 + 1);
+    store.maintain();
+    store.waitForMigration();
+    EXPECT_EQ(store.activeStorageKind(), StorageKind::AdjacencyList);
+
+    policy.min_density = 0.01;
+    store.setAdaptivePolicy(policy);
+    for (int i = 0; i < 64; ++i)
+        store.getEdge(i % 31, i % 31 + 1);
+    store.maintain();
+    store.waitForMigration();
+    EXPECT_EQ(store.activeStorageKind(), StorageKind::HybridCSR);
+}
+
+TEST(PeakStoreAdaptiveTest, MatrixGraphsDoNotMigrate) {
+    CinderPeak::PeakStore::PeakStore<int, int> store(GraphInternalMetadata("graph_matrix", true, true));
+    store.setAdaptivePolicy(eagerPolicy());
+    for (int v = 0; v < 16; ++v)
+        store.addVertex(v);
+    for (int v = 0; v < 15; ++v)
+        store.addEdge(v, v + 1, v);
+    for (int i = 0; i < 64; ++i)
+        store.getEdge(1, 2);
+    store.maintain();
+    store.waitForMigration();
+    EXPECT_EQ(store.activeStorageKind(), StorageKind::Matrix);
+}
+
+//
+// 3. Edge Insertion
+//
+
+TEST(PeakStoreInsertTest, AddEdgeRejectsExistingPairRegardlessOfWeight) {
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata());
+    store.addVertices(std::vector<int>{1, 2});
+    EXPECT_TRUE(store.addEdge(1, 2, 12).isOK());
+    EXPECT_EQ(store.addEdge(1, 2, 13).code(), StatusCode::EDGE_ALREADY_EXISTS);
+    EXPECT_EQ(store.getEdge(1, 2).first, 12);
+    EXPECT_EQ(store.getContext()->metadata->num_edges, 1);
+}
+
+TEST(PeakStoreInsertTest, UpsertOverwritesWithoutCountingTwice) {
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata());
+    store.addVertices(std::vector<int>{1, 2});
+    EXPECT_EQ(store.upsertEdge(1, 2, 12).first, EdgeInsertResult::Inserted);
+    EXPECT_EQ(store.upsertEdge(1, 2, 21).first, EdgeInsertResult::Updated);
+    EXPECT_EQ(store.getEdge(1, 2).first, 21);
+    EXPECT_EQ(store.getContext()->metadata->num_edges, 1);
+}
+
+TEST(PeakStoreInsertTest, MatrixCountsEachPairOnce) {
+    GraphCreationOptions opts({GraphCreationOptions::Directed, GraphCreationOptions::ParallelEdges});
+    CinderPeak::PeakStore::PeakStore<int, int> store(GraphInternalMetadata("graph_matrix", true, true), opts);
+    store.addVertices(std::vector<int>{1, 2});
+    store.addEdge(1, 2, 12);
+    store.addEdge(1, 2, 13);
+    EXPECT_EQ(store.getEdge(1, 2).first, 13);
+    EXPECT_EQ(store.getContext()->metadata->num_edges, 1);
+}
+
+//
+// 4. Iteration
+//
+
+TEST(PeakStoreIterationTest, VertexAndEdgeRangesCoverGraph) {
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata());
+    store.addVertices(std::vector<int>{10, 20, 30, 40});
+    store.addEdges(std::vector<std::tuple<int, int, int>>{{10, 20, 1}, {10, 30, 2}, {30, 10, 3}});
+
+    std::vector<int> vertices(store.vertices().begin(), store.vertices().end());
+    EXPECT_EQ(vertices, (std::vector<int>{10, 20, 30, 40}));
+
+    std::vector<std::tuple<int, int, int>> edges;
+    for (auto [src, dest, weight] : store.edges())
+        edges.emplace_back(src, dest, weight);
+    EXPECT_EQ(edges, (std::vector<std::tuple<int, int, int>>{{10, 20, 1}, {10, 30, 2}, {30, 10, 3}}));
+
+    EXPECT_EQ(store.neighbors(10).first.size(), 2);
+    EXPECT_EQ(store.neighbors(99).second.code(), StatusCode::VERTEX_NOT_FOUND);
+}
+
+TEST(PeakStoreIterationTest, EmptyGraphHasNoEdges) {
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata());
+    EXPECT_TRUE(store.edges().begin() == store.edges().end());
+    store.addVertex(1);
+    EXPECT_TRUE(store.edges().begin() == store.edges().end());
+}
+
+//
+// 5. Static Storage
+//
+
+TEST(PeakStoreStaticTest, StaticEnginesBehaveLikeDynamicOnes) {
+    using ListStore = CinderPeak::PeakStore::PeakStore<int, int, StaticStorage<AdjacencyList>>;
+    static_assert(std::is_same_v<ListStore::Engine, AdjacencyList<int, int>>);
+    ListStore store(listMetadata());
+    store.addVertices(std::vector<int>{1, 2, 3});
+    EXPECT_TRUE(store.addEdge(1, 2, 12).isOK());
+    EXPECT_EQ(store.addEdge(1, 2, 13).code(), StatusCode::EDGE_ALREADY_EXISTS);
+    store.addEdges(std::vector<std::tuple<int, int, int>>{{2, 3, 23}, {1, 2, 0}});
+    EXPECT_EQ(store.getEdge(2, 3).first, 23);
+    EXPECT_EQ(store.getContext()->metadata->num_edges, 2);
+    EXPECT_EQ(store.activeStorageKind(), StorageKind::AdjacencyList);
+
+    size_t edges = 0;
+    for (auto [src, dest, weight] : store.edges())
+        edges += weight > 0;
+    EXPECT_EQ(edges, 2);
+}
+
+TEST(PeakStoreStaticTest, StaticCSRAndMatrix) {
+    CinderPeak::PeakStore::PeakStore<int, int, StaticStorage<HybridCSR_COO>> csr(listMetadata());
+    csr.addVertices(std::vector<int>{1, 2});
+    csr.addEdge(1, 2, 12);
+    EXPECT_EQ(csr.getEdge(1, 2).first, 12);
+    EXPECT_EQ(csr.activeStorageKind(), StorageKind::HybridCSR);
+
+    GraphCreationOptions opts({GraphCreationOptions::Directed, GraphCreationOptions::Unweighted});
+    CinderPeak::PeakStore::PeakStore<int, int, StaticStorage<AdjacencyMatrix>> matrix(
+        GraphInternalMetadata("graph_matrix", true, true), opts);
+    matrix.addVertices(std::vector<int>{1, 2});
+    matrix.addEdge(2, 1);
+    EXPECT_EQ(matrix.neighbors(2).first.size(), 1);
+    EXPECT_EQ(matrix.activeStorageKind(), StorageKind::Matrix);
+}
+
+//
+// 6. Status
+//
+
+TEST(PeakStatusTest, StaticMessageWithOptionalDetail) {
+    PeakStatus status = PeakStatus::EdgeNotFound();
+    EXPECT_STREQ(status.staticMessage(), "Edge Not Found");
+    EXPECT_EQ(status.detail(), nullptr);
+    EXPECT_EQ(status.message(), "Edge Not Found");
+
+    PeakStatus detailed = status.withDetail("1 -> 2");
+    EXPECT_EQ(detailed.code(), StatusCode::EDGE_NOT_FOUND);
+    EXPECT_EQ(detailed.message(), "Edge Not Found: 1 -> 2");
+    // Copies share the detail instead of copying it.
+    PeakStatus copy = detailed;
+    EXPECT_EQ(copy.detail(), detailed.detail());
+    EXPECT_EQ(PeakStatus(StatusCode::INTERNAL_ERROR, std::string("boom")).message(), "boom");
+}
+
+//
+// 7. Concurrency
+//
+
+TEST(PeakStoreConcurrencyTest, ParallelWritersAndReaders) {
+    GraphCreationOptions opts({GraphCreationOptions::Directed, GraphCreationOptions::Weighted,
+                               GraphCreationOptions::Concurrent});
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata(), opts);
+    constexpr int threads = 4;
+    constexpr int per_thread = 200;
+    // Every thread links into thread 0's vertices, so add those up front.
+    for (int i = 0; i < per_thread; ++i)
+        store.addVertex(i);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&store, t] {
+            const int base = t * per_thread;
+            for (int i = 0; i < per_thread; ++i)
+                store.addVertex(base + i);
+            for (int i = 1; i < per_thread; ++i) {
+                store.addEdge(base + i - 1, base + i, i);
+                store.addEdge(i - 1, base + i, i);
+                store.getEdge(base + i - 1, base + i);
+                store.getNeighbors(i - 1);
+            }
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+
+    EXPECT_EQ(store.getContext()->metadata->num_vertices, threads * per_thread);
+    // Thread 0's two edge streams coincide, so it adds each edge once.
+    EXPECT_EQ(store.getContext()->metadata->num_edges, (2 * threads - 1) * (per_thread - 1));
+    EXPECT_EQ(store.getEdge(3 * per_thread + 9, 3 * per_thread + 10).first, 10);
+    EXPECT_EQ(store.getNeighbors(5).first.size(), threads);
+    EXPECT_EQ(store.activeStorageKind(), StorageKind::AdjacencyList);
+}
+
+//
+// 8. Ingest
+//
+
+TEST(PeakStoreIngestTest, ProducersBuildOneCSR) {
+    GraphCreationOptions opts({GraphCreationOptions::Directed, GraphCreationOptions::Weighted});
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata(), opts);
+    store.addVertices(std::vector<int>{0, 1, 5000});
+    store.addEdge(0, 1, 7);
+
+    auto pipeline = store.beginIngest();
+    constexpr int threads = 4;
+    constexpr int per_thread = 500;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; ++t) {
+        producers.emplace_back([&pipeline, t] {
+            std::vector<std::tuple<int, int, int>> batch;
+            for (int i = 0; i < per_thread; ++i) {
+                const int v = t * per_thread + i;
+                batch.emplace_back(v, (v + 1) % (threads * per_thread), v);
+            }
+            // A duplicate of the existing edge and a self loop, both dropped.
+            batch.emplace_back(0, 1, -1);
+            batch.emplace_back(5, 5, 1);
+            pipeline.push(batch);
+        });
+    }
+    for (auto &producer : producers)
+        producer.join();
+    EXPECT_EQ(pipeline.size(), threads * (per_thread + 2));
+
+    EXPECT_TRUE(store.commitIngest(pipeline).isOK());
+    EXPECT_EQ(pipeline.size(), 0);
+    EXPECT_EQ(store.activeStorageKind(), StorageKind::HybridCSR);
+    EXPECT_EQ(store.getContext()->metadata->num_vertices, threads * per_thread + 1);
+    EXPECT_EQ(store.getContext()->metadata->num_edges, threads * per_thread);
+    EXPECT_EQ(store.getEdge(0, 1).first, 7);
+    EXPECT_EQ(store.getEdge(1234, 1235).first, 1234);
+    EXPECT_EQ(store.getEdge(threads * per_thread - 1, 0).first, threads * per_thread - 1);
+    EXPECT_FALSE(store.getEdge(5, 5).second.isOK());
+    EXPECT_TRUE(store.neighbors(5000).second.isOK());
+
+    size_t edges = 0;
+    for (auto [src, dest, weight] : store.edges()) {
+        EXPECT_EQ(dest, (src + 1) % (threads * per_thread));
+        ++edges;
+    }
+    EXPECT_EQ(edges, threads * per_thread);
+}
+
+TEST(PeakStoreIngestTest, CommitsMergeIntoExistingRows) {
+    GraphCreationOptions opts({GraphCreationOptions::Directed, GraphCreationOptions::Weighted,
+                               GraphCreationOptions::SelfLoops});
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata(), opts);
+    auto pipeline = store.beginIngest();
+    pipeline.push(std::vector<std::tuple<int, int, int>>{{1, 2, 5}, {2, 2, 1}});
+    EXPECT_TRUE(store.commitIngest(pipeline).isOK());
+    store.addVertex(3);
+    store.addEdge(3, 1, 8);
+    // Repeats of existing edges are dropped; the rest join their rows.
+    pipeline.push(std::vector<std::tuple<int, int, int>>{
+        {1, 2, 9}, {1, 3, 4}, {2, 2, 7}, {4, 1, 1}, {1, 0, 6}});
+    EXPECT_TRUE(store.commitIngest(pipeline).isOK());
+
+    const auto &metadata = *store.getContext()->metadata;
+    EXPECT_EQ(metadata.num_vertices, 5);
+    EXPECT_EQ(metadata.num_edges, 6);
+    EXPECT_EQ(metadata.num_self_loops, 1);
+    EXPECT_EQ(store.getEdge(1, 2).first, 5);
+    EXPECT_EQ(store.getEdge(2, 2).first, 1);
+    EXPECT_EQ(store.getEdge(3, 1).first, 8);
+    std::vector<std::pair<int, int>> row;
+    for (const auto &[dest, weight] : store.getNeighbors(1).first)
+        row.emplace_back(dest, weight);
+    std::sort(row.begin(), row.end());
+    EXPECT_EQ(row, (std::vector<std::pair<int, int>>{{0, 6}, {2, 5}, {3, 4}}));
+}
+
+TEST(PeakStoreIngestTest, CommitsCountParallelEdgesAcrossBatches) {
+    GraphCreationOptions opts({GraphCreationOptions::Directed, GraphCreationOptions::Weighted,
+                               GraphCreationOptions::ParallelEdges});
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata(), opts);
+    auto pipeline = store.beginIngest();
+    pipeline.push(std::vector<std::tuple<int, int, int>>{{1, 2, 1}, {1, 2, 2}});
+    EXPECT_TRUE(store.commitIngest(pipeline).isOK());
+    pipeline.push(std::vector<std::tuple<int, int, int>>{{1, 2, 3}, {1, 3, 1}});
+    EXPECT_TRUE(store.commitIngest(pipeline).isOK());
+
+    const auto &metadata = *store.getContext()->metadata;
+    EXPECT_EQ(metadata.num_edges, 4);
+    EXPECT_EQ(metadata.num_parallel_edges, 2);
+    std::vector<int> weights;
+    for (const auto &[dest, weight] : store.getNeighbors(1).first) {
+        if (dest == 2)
+            weights.push_back(weight);
+    }
+    // Existing edges stay ahead of the batch's.
+    EXPECT_EQ(weights, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(PeakStoreIngestTest, ConcurrentStoreInsertsPartitions) {
+    GraphCreationOptions opts({GraphCreationOptions::Directed, GraphCreationOptions::Weighted,
+                               GraphCreationOptions::Concurrent});
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata(), opts);
+    auto pipeline = store.beginIngest();
+    pipeline.push(std::vector<std::tuple<int, int, int>>{{1, 2, 3}, {2, 3, 4}, {1, 2, 5}});
+    pipeline.pushVertices(std::vector<int>{9});
+
+    EXPECT_TRUE(store.commitIngest(pipeline).isOK());
+    EXPECT_EQ(store.activeStorageKind(), StorageKind::AdjacencyList);
+    EXPECT_EQ(store.getContext()->metadata->num_vertices, 4);
+    EXPECT_EQ(store.getContext()->metadata->num_edges, 2);
+    EXPECT_EQ(store.getEdge(1, 2).first, 3);
+    EXPECT_EQ(store.getEdge(2, 3).first, 4);
+}
+
+//
+// 9. Statistics
+//
+
+TEST(PeakStoreStatsTest, TracksSelfLoopsParallelEdgesAndDensity) {
+    GraphCreationOptions opts({GraphCreationOptions::Directed, GraphCreationOptions::Weighted,
+                               GraphCreationOptions::SelfLoops,
+                               GraphCreationOptions::ParallelEdges});
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata(), opts);
+    store.addVertices(std::vector<int>{1, 2, 3, 4});
+    store.addEdge(1, 2, 1);
+    store.addEdge(1, 2, 2);
+    store.addEdge(3, 3, 1);
+    store.addEdges(std::vector<std::tuple<int, int, int>>{{1, 2, 3}, {2, 3, 1}, {2, 3, 2}, {4, 4, 1}});
+
+    const auto &metadata = *store.getContext()->metadata;
+    EXPECT_EQ(metadata.num_edges, 7);
+    EXPECT_EQ(metadata.num_self_loops, 2);
+    EXPECT_EQ(metadata.num_parallel_edges, 3);
+    EXPECT_DOUBLE_EQ(metadata.density(), 7.0 / 12.0);
+}
+
+TEST(PeakStoreStatsTest, CSREngineReportsParallelEdges) {
+    GraphCreationOptions opts({GraphCreationOptions::Directed, GraphCreationOptions::ParallelEdges});
+    CinderPeak::PeakStore::PeakStore<int, int, StaticStorage<HybridCSR_COO>> store(listMetadata(),
+                                                                                  opts);
+    store.addVertices(std::vector<int>{1, 2, 3});
+    store.addEdges(std::vector<std::pair<int, int>>{{1, 2}, {1, 2}, {2, 3}});
+    store.addEdge(2, 3, 0);
+    store.addEdges(std::vector<std::pair<int, int>>{{1, 2}, {3, 1}, {3, 1}});
+
+    const auto &metadata = *store.getContext()->metadata;
+    EXPECT_EQ(metadata.num_edges, 7);
+    EXPECT_EQ(metadata.num_parallel_edges, 4);
+}
+
+TEST(PeakStoreStatsTest, CountersAggregateAcrossThreads) {
+    GraphCreationOptions opts({GraphCreationOptions::Undirected, GraphCreationOptions::SelfLoops,
+                               GraphCreationOptions::Concurrent});
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata(), opts);
+    constexpr int threads = 4;
+    constexpr int per_thread = 100;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&store, t] {
+            for (int i = 0; i < per_thread; ++i) {
+                const int v = t * per_thread + i;
+                store.addVertex(v);
+                store.addEdge(v, v);
+            }
+        });
+    }
+    for (auto &worker : workers)
+        worker.join();
+
+    const auto &metadata = *store.getContext()->metadata;
+    EXPECT_EQ(metadata.num_vertices, threads * per_thread);
+    EXPECT_EQ(metadata.num_edges, threads * per_thread);
+    EXPECT_EQ(metadata.num_self_loops, threads * per_thread);
+    EXPECT_EQ(metadata.num_parallel_edges, 0);
+    EXPECT_FALSE(metadata.directed);
+}
+
+TEST(PeakStoreStatsTest, InstrumentedStoreReportsLatencies) {
+    GraphCreationOptions opts({GraphCreationOptions::Directed, GraphCreationOptions::Weighted,
+                               GraphCreationOptions::Instrumented});
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata(), opts);
+    store.addVertices(std::vector<int>{1, 2, 3});
+    store.addEdge(1, 2, 4);
+    store.addEdge(2, 3, 5);
+    store.getEdge(1, 2);
+    store.getNeighbors(1);
+    auto pipeline = store.beginIngest();
+    pipeline.push(std::vector<std::tuple<int, int, int>>{{3, 1, 6}});
+    store.commitIngest(pipeline);
+    store.addEdges(std::vector<std::tuple<int, int, int>>{{1, 3, 7}});
+    store.getContext()->hybrid_storage->flush();
+
+    auto stats = store.stats();
+    EXPECT_TRUE(stats.instrumented);
+    EXPECT_EQ(stats.active_storage, "hybrid_csr");
+    EXPECT_EQ(stats.num_edges, 4);
+    auto op = [&stats](const std::string &name) {
+        for (const auto &operation : stats.operations) {
+            if (operation.name == name)
+                return operation.latency;
+        }
+        return LatencyHistogram::Summary{};
+    };
+    EXPECT_EQ(op("add_edge").count, 2);
+    EXPECT_EQ(op("add_vertices").count, 1);
+    EXPECT_EQ(op("get_edge").count, 1);
+    EXPECT_EQ(op("get_neighbors").count, 1);
+    EXPECT_EQ(op("csr_rebuild").count, 1);
+    EXPECT_LE(op("add_edge").p50_ns, op("add_edge").max_ns);
+    EXPECT_GT(op("add_edge").total_ns, 0);
+
+    const std::string json = stats.toJson();
+    EXPECT_NE(json.find("\"active_storage\":\"hybrid_csr\""), std::string::npos);
+    EXPECT_NE(json.find("\"add_edge\":{\"count\":2"), std::string::npos);
+    EXPECT_NE(json.find("\"hybrid_csr\":{\"bytes\":"), std::string::npos);
+}
+
+TEST(PeakStoreStatsTest, UninstrumentedStoreReportsCountersOnly) {
+    CinderPeak::PeakStore::PeakStore<int, int> store(listMetadata());
+    store.addVertices(std::vector<int>{1, 2});
+    store.addEdge(1, 2);
+    auto stats = store.stats();
+    EXPECT_FALSE(stats.instrumented);
+    EXPECT_TRUE(stats.operations.empty());
+    EXPECT_EQ(stats.num_vertices, 2);
+    EXPECT_EQ(stats.num_edges, 1);
+    EXPECT_GT(stats.engines.front().bytes, 0);
+}
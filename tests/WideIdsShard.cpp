@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+// Must come before any CinderPeak header; every test here runs on 64-bit ids.
+#define CINDERPEAK_64BIT_VERTEX_IDS
+#include "CinderPeak.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace CinderPeak;
+using namespace CinderPeak::Algorithms;
+
+static_assert(sizeof(VertexId) == 8, "64-bit ids are not enabled");
+
+//
+// 1. Triangles
+//
+
+TEST(WideIdsTest, IntersectionComparesWholeIds) {
+    // Ids that only differ above bit 31 must not match.
+    const VertexId high = VertexId{1} << 32;
+    std::vector<VertexId> a, b;
+    for (VertexId v = 0; v < 16; ++v) {
+        a.push_back(v);
+        b.push_back(v % 2 ? v : high + v);
+    }
+    std::sort(b.begin(), b.end());
+    std::vector<VertexId> found;
+    size_t count = detail::intersectSorted(
+        a.data(), a.size(), b.data(), b.size(),
+        [&](VertexId w) { found.push_back(w); });
+    EXPECT_EQ(count, 8u);
+    for (VertexId w : found)
+        EXPECT_EQ(w % 2, 1u);
+}
+
+TEST(WideIdsTest, CompleteGraphTriangles) {
+    GraphList<int, int> graph;
+    for (int v = 0; v < 12; ++v)
+        graph.addVertex(v);
+    for (int u = 0; u < 12; ++u) {
+        for (int v = u + 1; v < 12; ++v)
+            graph.addEdge(u, v);
+    }
+    auto result = graph.triangles();
+    EXPECT_EQ(result.triangles, 220u);
+    EXPECT_DOUBLE_EQ(result.transitivity, 1.0);
+    for (int v = 0; v < 12; ++v)
+        EXPECT_EQ(result.per_vertex[graph.vertexId(v)], 55u);
+}